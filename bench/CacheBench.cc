@@ -0,0 +1,79 @@
+#include <Infrastructure/Cache/Cache.h>
+#include <benchmark/benchmark.h>
+#include <boost/url.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace evento;
+
+std::vector<std::string> makeKeys(std::size_t count) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys.push_back(CacheManager::generateKey(
+            http::verb::get,
+            urls::url("https://evento.sast.fun/api/v2/client/event/" + std::to_string(i)),
+            {{"page", "1"}, {"size", "10"}}));
+    }
+    return keys;
+}
+
+CacheEntry makeEntry(std::size_t size) {
+    return {
+        .data = {},
+        .insertTime = std::chrono::steady_clock::now(),
+        .ttl = std::chrono::minutes(1),
+        .size = size,
+    };
+}
+
+void BM_CacheGenerateKey(benchmark::State& state) {
+    urls::url url("https://evento.sast.fun/api/v2/client/event/query");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CacheManager::generateKey(http::verb::get,
+                                                           url,
+                                                           {{"page", "1"},
+                                                            {"size", "10"},
+                                                            {"start", "2024-10-14"},
+                                                            {"end", "2024-10-21"}}));
+    }
+}
+BENCHMARK(BM_CacheGenerateKey);
+
+// keys, entry size, past 64MiB every insert evicts
+void BM_CacheInsert(benchmark::State& state) {
+    auto keys = makeKeys(state.range(0));
+    auto entry = makeEntry(state.range(1));
+    CacheManager cache;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        cache.insert(keys[i++ % keys.size()], entry);
+    }
+    cache.clearMemoryCache();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheInsert)
+    ->Args({1 << 6, 1 << 10})
+    ->Args({1 << 14, 1 << 10})
+    ->Args({1 << 14, 1 << 14});
+
+// keys, all of them cached
+void BM_CacheGet(benchmark::State& state) {
+    auto keys = makeKeys(state.range(0));
+    CacheManager cache;
+    for (auto const& key : keys) {
+        cache.insert(key, makeEntry(1 << 10));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cache.get(keys[i++ % keys.size()]));
+    }
+    cache.clearMemoryCache();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheGet)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+
+} // namespace
@@ -0,0 +1,19 @@
+#include "Corpus.h"
+#include <Controller/Convert.h>
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using namespace evento;
+
+// events in the list
+void BM_ConvertEventList(benchmark::State& state) {
+    auto events = bench::eventEntities(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convert::from(events));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvertEventList)->RangeMultiplier(10)->Range(10, 100'000);
+
+} // namespace
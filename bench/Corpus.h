@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Infrastructure/Network/ResponseStruct.h>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace evento::bench {
+
+// the events of `corpus/events.json`, see `corpus/generate.py`
+inline nlohmann::json const& corpusEvents() {
+    static nlohmann::json const s_events = [] {
+        std::ifstream file(EVENTO_BENCH_CORPUS "/events.json");
+        if (!file.is_open()) {
+            throw std::runtime_error("missing " EVENTO_BENCH_CORPUS "/events.json");
+        }
+        return nlohmann::json::parse(file).at("elements");
+    }();
+    return s_events;
+}
+
+// an `EventQueryRes` response body of `count` events, the corpus is repeated as often as needed
+// with fresh ids and each repetition a year later, so that every event stays distinct
+inline std::string const& eventQueryPayload(std::size_t count) {
+    static std::map<std::size_t, std::string> s_payloads;
+    if (auto it = s_payloads.find(count); it != s_payloads.end()) {
+        return it->second;
+    }
+
+    auto const& events = corpusEvents();
+    auto elements = nlohmann::json::array();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto event = events[i % events.size()];
+        auto round = static_cast<int>(i / events.size());
+        event["id"] = static_cast<int>(i) + 1000;
+        for (auto field : {"start", "end"}) {
+            auto date = event[field].get<std::string>();
+            date.replace(0, 4, std::to_string(std::stoi(date.substr(0, 4)) + round));
+            event[field] = date;
+        }
+        elements.push_back(std::move(event));
+    }
+    nlohmann::json payload = {{"elements", std::move(elements)},
+                              {"current", 1},
+                              {"total", static_cast<int>(count)}};
+    return s_payloads.emplace(count, payload.dump()).first->second;
+}
+
+inline std::vector<EventEntity> eventEntities(std::size_t count) {
+    return nlohmann::json::parse(eventQueryPayload(count)).get<EventQueryRes>().elements;
+}
+
+// what `MockServer` serves
+struct Dataset {
+    std::vector<EventEntity> events;
+    std::vector<std::string> departments;
+    std::vector<FeedbackEntity> feedback; // of the current user, one per event at most
+};
+
+// `count` events of the corpus, with the departments they name and no feedback
+inline Dataset corpusDataset(std::size_t count) {
+    Dataset dataset{.events = eventEntities(count)};
+    std::set<std::string> departments;
+    for (auto const& event : dataset.events) {
+        departments.insert(event.larkDepartmentName);
+    }
+    dataset.departments.assign(departments.begin(), departments.end());
+    return dataset;
+}
+
+// written by `corpus/generate.py --dataset <dir>`, throws if a file is missing or malformed
+inline Dataset loadDataset(std::filesystem::path const& dir) {
+    auto load = [&dir](const char* name) {
+        std::ifstream file(dir / name);
+        if (!file.is_open()) {
+            throw std::runtime_error("missing " + (dir / name).string());
+        }
+        return nlohmann::json::parse(file);
+    };
+    Dataset dataset{
+        .events = load("events.json").get<EventQueryRes>().elements,
+        .feedback = load("feedback.json").get<std::vector<FeedbackEntity>>(),
+    };
+    for (auto const& department : load("departments.json").get<std::vector<DepartmentEntity>>()) {
+        dataset.departments.push_back(department.name);
+    }
+    return dataset;
+}
+
+} // namespace evento::bench
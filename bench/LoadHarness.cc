@@ -0,0 +1,305 @@
+#include "MockServer.h"
+#include <Infrastructure/Network/NetworkClient.h>
+#include <algorithm>
+#include <boost/asio/detached.hpp>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Drives `NetworkClient` with concurrent scenarios against `MockServer`, started in-process
+// unless `EVENTO_API_GATEWAY` is set already, and reports throughput and latency percentiles.
+
+namespace {
+
+using namespace evento;
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+constexpr const char USAGE[] =
+    R"(usage: sast-evento-load [options]
+  --concurrency <n>     scenarios running at once, default 8
+  --duration <s>        how long to run, default 10
+  --profile <name>      lan, wifi, mobile or flaky for the in-process mock server, default lan
+  --error-rate <0..1>   share of failing responses of the in-process mock server
+  --events <n>          events served by the in-process mock server, default 100
+  --changes <on|off>    keep the change feed open, subscribe to events among the calls and
+                        report how long their changes take to be pushed, default off
+  --hedging <on|off>    hedge GETs slower than the p95 latency of their host, default off
+Set EVENTO_API_GATEWAY and EVENTO_GITHUB_GATEWAY to run against an external server instead.
+)";
+
+// a call of the client as the app makes it, without the response cache
+struct Operation {
+    const char* name;
+    std::function<Task<bool>(std::mt19937&)> run;
+};
+
+template<typename T>
+Task<bool> succeeded(Task<Result<T>> task) {
+    co_return (co_await std::move(task)).isOk();
+}
+
+std::vector<Operation> operations(int events) {
+    return {
+        {"active events", [](auto&) { return succeeded(networkClient()->getActiveEventList(0s)); }},
+        {"latest events", [](auto&) { return succeeded(networkClient()->getLatestEventList(0s)); }},
+        {"history events",
+         [](auto&) { return succeeded(networkClient()->getHistoryEventList(1, 10, 0s)); }},
+        {"event by id",
+         [events](std::mt19937& random) {
+             std::uniform_int_distribution<> id(1000, 1000 + events - 1);
+             return succeeded(networkClient()->getEventById(id(random)));
+         }},
+        {"departments", [](auto&) { return succeeded(networkClient()->getDepartmentList(0s)); }},
+        {"home slides", [](auto&) { return succeeded(networkClient()->getHomeSlide(0s)); }},
+        {"contributors", [](auto&) { return succeeded(networkClient()->getContributors()); }},
+        {"latest release", [](auto&) { return succeeded(networkClient()->getLatestRelease()); }},
+    };
+}
+
+// subscribing runs through the change feed, from the request to the pushed change
+struct PushStats {
+    std::unordered_map<int, Clock::time_point> sent; // by event id
+    std::vector<std::chrono::microseconds> latencies;
+    std::uint64_t changes = 0;
+    PushState state = PushState::Disconnected;
+};
+
+Operation subscribeOperation(int events, PushStats& push) {
+    return {"subscribe", [events, &push](std::mt19937& random) {
+                std::uniform_int_distribution<> id(1000, 1000 + events - 1);
+                auto eventId = id(random);
+                push.sent.insert_or_assign(eventId, Clock::now());
+                return succeeded(networkClient()->subscribeEvent(eventId, random() % 2 == 0));
+            }};
+}
+
+// every sample is kept, percentiles are exact
+struct OperationStats {
+    std::vector<std::chrono::microseconds> latencies;
+    std::uint64_t failures = 0;
+
+    [[nodiscard]] double percentileMs(double ratio) const {
+        if (latencies.empty()) {
+            return 0;
+        }
+        auto index = static_cast<std::size_t>(ratio * static_cast<double>(latencies.size() - 1));
+        return static_cast<double>(latencies[index].count()) / 1000;
+    }
+};
+
+// runs in the client io thread only, so the stats need no lock
+Task<void> scenario(unsigned seed,
+                    std::vector<Operation> const& operations,
+                    Clock::time_point deadline,
+                    std::map<std::string, OperationStats>& stats) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, operations.size() - 1);
+    while (Clock::now() < deadline) {
+        auto const& operation = operations[pick(random)];
+        auto start = Clock::now();
+        auto ok = co_await operation.run(random);
+        auto& entry = stats[operation.name];
+        entry.latencies.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start));
+        if (!ok) {
+            ++entry.failures;
+        }
+    }
+}
+
+void setEnv(const char* name, std::string const& value) {
+#ifdef PLATFORM_WINDOWS
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+template<typename T>
+bool parseNumber(std::string_view text, T& value) {
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+std::string row(std::string_view name, OperationStats& stats) {
+    std::sort(stats.latencies.begin(), stats.latencies.end());
+    return std::format("{:<16}{:>8}{:>8}{:>9.1f}{:>9.1f}{:>9.1f}{:>9.1f}\n",
+                       name,
+                       stats.latencies.size(),
+                       stats.failures,
+                       stats.percentileMs(0.5),
+                       stats.percentileMs(0.95),
+                       stats.percentileMs(0.99),
+                       stats.percentileMs(1));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int concurrency = 8;
+    int duration = 10;
+    int events = 100;
+    bool changes = false;
+    bool hedging = false;
+    auto profile = *bench::MockProfile::named("lan");
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view option = argv[i];
+        if (option == "--help" || option == "-h" || i + 1 >= argc) {
+            std::fputs(USAGE, option == "--help" || option == "-h" ? stdout : stderr);
+            return option == "--help" || option == "-h" ? 0 : 1;
+        }
+        std::string_view value = argv[++i];
+        bool valid = true;
+        if (option == "--concurrency") {
+            valid = parseNumber(value, concurrency) && concurrency > 0;
+        } else if (option == "--duration") {
+            valid = parseNumber(value, duration) && duration > 0;
+        } else if (option == "--profile") {
+            auto named = bench::MockProfile::named(value);
+            valid = named.has_value();
+            if (valid) {
+                profile = *named;
+            }
+        } else if (option == "--error-rate") {
+            valid = parseNumber(value, profile.errorRate) && profile.errorRate >= 0
+                    && profile.errorRate <= 1;
+        } else if (option == "--events") {
+            valid = parseNumber(value, events) && events > 0;
+        } else if (option == "--changes") {
+            valid = value == "on" || value == "off";
+            changes = value == "on";
+        } else if (option == "--hedging") {
+            valid = value == "on" || value == "off";
+            hedging = value == "on";
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            std::fprintf(stderr, "invalid option: %s %s\n%s", argv[i - 1], argv[i], USAGE);
+            return 1;
+        }
+    }
+    spdlog::set_level(spdlog::level::warn);
+    if (hedging) {
+        // read by `NetworkClient` on first use
+        setEnv("EVENTO_HEDGING", "1");
+    }
+
+    // the mock gets a thread of its own, so that serving does not steal time from the client
+    net::io_context serverIoc;
+    std::optional<bench::MockServer> server;
+    std::thread serverThread;
+    auto gateway = std::getenv("EVENTO_API_GATEWAY");
+    if (!gateway || !*gateway) {
+        server.emplace(serverIoc, profile, events);
+        server->listen();
+        // read by `NetworkClient` on first use
+        setEnv("EVENTO_API_GATEWAY", server->eventoGateway());
+        setEnv("EVENTO_GITHUB_GATEWAY", server->githubGateway());
+        serverThread = std::thread([&serverIoc] {
+            auto work = net::make_work_guard(serverIoc);
+            serverIoc.run();
+        });
+    }
+
+    auto ops = operations(events);
+    std::map<std::string, OperationStats> stats;
+    // outlives the connections pooled by the `networkClient()` singleton
+    static net::io_context ioc;
+    PushStats push;
+    if (changes) {
+        ops.push_back(subscribeOperation(events, push));
+        ChangeListener listener{.state = [&push](PushState state) { push.state = state; },
+                                .change = [&push](EventChange const& change) {
+                                    ++push.changes;
+                                    auto it = push.sent.find(change.id);
+                                    if (it == push.sent.end()) {
+                                        return;
+                                    }
+                                    push.latencies.push_back(
+                                        std::chrono::duration_cast<std::chrono::microseconds>(
+                                            Clock::now() - it->second));
+                                    push.sent.erase(it);
+                                }};
+        net::co_spawn(ioc, networkClient()->watchChanges(std::move(listener)), net::detached);
+    }
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(duration);
+    for (int i = 0; i < concurrency; ++i) {
+        net::co_spawn(ioc, scenario(i + 1, ops, deadline, stats), net::detached);
+    }
+    if (changes) {
+        // the change feed runs until stopped
+        net::co_spawn(
+            ioc,
+            [deadline]() -> Task<void> {
+                net::steady_timer timer(co_await net::this_coro::executor, deadline + 1s);
+                co_await timer.async_wait(net::use_awaitable);
+                ioc.stop();
+            },
+            net::detached);
+    }
+    ioc.run();
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    OperationStats total;
+    std::string table = std::format("{:<16}{:>8}{:>8}{:>9}{:>9}{:>9}{:>9}\n",
+                                    "operation",
+                                    "calls",
+                                    "failed",
+                                    "p50 ms",
+                                    "p95 ms",
+                                    "p99 ms",
+                                    "max ms");
+    for (auto& [name, entry] : stats) {
+        total.latencies.insert(total.latencies.end(),
+                               entry.latencies.begin(),
+                               entry.latencies.end());
+        total.failures += entry.failures;
+        table += row(name, entry);
+    }
+    table += row("total", total);
+
+    std::printf("%d scenarios for %.1fs: %.1f calls/s\n\n%s\n%s",
+                concurrency,
+                elapsed,
+                static_cast<double>(total.latencies.size()) / elapsed,
+                table.c_str(),
+                networkClient()->metrics().dump().c_str());
+    if (changes) {
+        OperationStats latency{.latencies = std::move(push.latencies)};
+        std::sort(latency.latencies.begin(), latency.latencies.end());
+        std::printf("\nchange feed %s: %llu changes, subscribe to push p50 %.1fms, p95 %.1fms, "
+                    "%zu subscriptions without a push\n",
+                    push.state == PushState::Connected      ? "connected"
+                    : push.state == PushState::Unavailable ? "unavailable"
+                                                             : "disconnected",
+                    static_cast<unsigned long long>(push.changes),
+                    latency.percentileMs(0.5),
+                    latency.percentileMs(0.95),
+                    push.sent.size());
+#ifdef EVENTO_API_V1
+        std::printf("API v1 has no change feed, configure with -DEVENTO_API_V1=OFF for one\n");
+#endif
+    }
+    if (server) {
+        std::printf("\nmock server: %llu requests, %llu injected errors\n",
+                    static_cast<unsigned long long>(server->requests()),
+                    static_cast<unsigned long long>(server->injectedErrors()));
+        serverIoc.stop();
+        serverThread.join();
+    }
+}
@@ -0,0 +1,679 @@
+#include "MockServer.h"
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace evento::bench {
+
+namespace {
+
+constexpr std::size_t WRITE_CHUNK_SIZE = 16 * 1024;
+constexpr std::chrono::seconds STALL_TIME{60};
+constexpr std::chrono::seconds HEARTBEAT_INTERVAL{15};
+constexpr std::size_t CHANGE_LOG_SIZE = 1024;
+constexpr char CHANGES_PATH[] = "/api/v2/client/event/changes";
+
+// "a=1&b=2" into its pairs, values are not percent-decoded
+std::map<std::string, std::string> parseQuery(std::string_view query) {
+    std::map<std::string, std::string> params;
+    while (!query.empty()) {
+        auto end = query.find('&');
+        auto pair = query.substr(0, end);
+        auto equal = pair.find('=');
+        params.emplace(std::string(pair.substr(0, equal)),
+                       equal == std::string_view::npos ? std::string()
+                                                       : std::string(pair.substr(equal + 1)));
+        query = end == std::string_view::npos ? std::string_view{} : query.substr(end + 1);
+    }
+    return params;
+}
+
+// "%E5%89%8D+x" into "前 x"
+std::string percentDecoded(std::string_view value) {
+    std::string decoded;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        int byte = 0;
+        if (value[i] == '%' && i + 2 < value.size()
+            && std::from_chars(value.data() + i + 1, value.data() + i + 3, byte, 16).ptr
+                   == value.data() + i + 3) {
+            decoded += static_cast<char>(byte);
+            i += 2;
+        } else {
+            decoded += value[i] == '+' ? ' ' : value[i];
+        }
+    }
+    return decoded;
+}
+
+int intParam(std::map<std::string, std::string> const& params, std::string const& key, int value) {
+    if (auto it = params.find(key); it != params.end()) {
+        std::from_chars(it->second.data(), it->second.data() + it->second.size(), value);
+    }
+    return value;
+}
+
+// a P-256 key and a certificate for "localhost" signed by it, valid for a day
+void useSelfSignedCertificate(ssl::context& ctx) {
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(EVP_EC_gen("P-256"), EVP_PKEY_free);
+    std::unique_ptr<X509, decltype(&X509_free)> cert(X509_new(), X509_free);
+    if (!key || !cert) {
+        throw std::runtime_error("failed to create the certificate of the mock server");
+    }
+    X509_set_version(cert.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 24 * 60 * 60);
+    X509_set_pubkey(cert.get(), key.get());
+    auto name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name,
+                               "CN",
+                               MBSTRING_ASC,
+                               reinterpret_cast<unsigned char const*>("localhost"),
+                               -1,
+                               -1,
+                               0);
+    X509_set_issuer_name(cert.get(), name);
+    X509_sign(cert.get(), key.get(), EVP_sha256());
+
+    SSL_CTX_use_certificate(ctx.native_handle(), cert.get());
+    SSL_CTX_use_PrivateKey(ctx.native_handle(), key.get());
+}
+
+StateV1 toV1(State state) {
+    switch (state) {
+    case State::SigningUp:
+        return StateV1::Registration;
+    case State::Active:
+        return StateV1::Ongoing;
+    case State::Completed:
+        return StateV1::Over;
+    case State::Cancelled:
+        return StateV1::Cancelled;
+    }
+    return StateV1::Uninitialized;
+}
+
+} // namespace
+
+std::optional<MockProfile> MockProfile::named(std::string_view name) {
+    using std::chrono::milliseconds;
+    if (name == "lan") {
+        return MockProfile{.latency = milliseconds(1)};
+    }
+    if (name == "wifi") {
+        return MockProfile{.latency = milliseconds(20),
+                           .jitter = milliseconds(15),
+                           .bandwidth = 5 * 1024 * 1024};
+    }
+    if (name == "mobile") {
+        return MockProfile{.latency = milliseconds(120),
+                           .jitter = milliseconds(80),
+                           .bandwidth = 256 * 1024,
+                           .errorRate = 0.01};
+    }
+    if (name == "flaky") {
+        return MockProfile{.latency = milliseconds(60),
+                           .jitter = milliseconds(300),
+                           .bandwidth = 1024 * 1024,
+                           .errorRate = 0.1};
+    }
+    return std::nullopt;
+}
+
+MockServer::MockServer(net::io_context& ioc, MockProfile profile, std::size_t events)
+    : MockServer(ioc, profile, corpusDataset(events)) {}
+
+MockServer::MockServer(net::io_context& ioc, MockProfile profile, Dataset dataset)
+    : _ioc(ioc)
+    , _ctx(ssl::context::tlsv12_server)
+    , _profile(profile)
+    , _events(std::move(dataset.events))
+    , _departments(std::move(dataset.departments)) {
+    useSelfSignedCertificate(_ctx);
+
+    for (std::size_t i = 0; i < _events.size(); ++i) {
+        _eventIndex.emplace(_events[i].id, i);
+    }
+    for (auto& feedback : dataset.feedback) {
+        _feedback.emplace(feedback.eventId, std::move(feedback));
+    }
+}
+
+unsigned short MockServer::listen(unsigned short port) {
+    _acceptor.emplace(_ioc, tcp::endpoint(net::ip::address_v4::loopback(), port));
+    _port = _acceptor->local_endpoint().port();
+    net::co_spawn(_ioc, accept(), net::detached);
+    spdlog::info("Mock server listening on 127.0.0.1:{}", _port);
+    return _port;
+}
+
+void MockServer::changeEvery(std::chrono::milliseconds interval) {
+    net::co_spawn(_ioc, changeLoop(interval), net::detached);
+}
+
+std::string MockServer::eventoGateway() const {
+    return std::format("https://127.0.0.1:{}/api", _port);
+}
+
+std::string MockServer::githubGateway() const {
+    return std::format("https://127.0.0.1:{}/repos", _port);
+}
+
+Task<void> MockServer::accept() {
+    while (_acceptor->is_open()) {
+        auto [ec, socket] = co_await _acceptor->async_accept(net::as_tuple(net::use_awaitable));
+        if (ec) {
+            if (ec == net::error::operation_aborted) {
+                co_return;
+            }
+            continue;
+        }
+        net::co_spawn(_ioc, session(std::move(socket)), net::detached);
+    }
+}
+
+Task<void> MockServer::session(tcp::socket socket) {
+    ssl::stream<tcp::socket> stream(std::move(socket), _ctx);
+    try {
+        co_await stream.async_handshake(ssl::stream_base::server, net::use_awaitable);
+
+        beast::flat_buffer buffer;
+        for (;;) {
+            Request req;
+            co_await http::async_read(stream, buffer, req, net::use_awaitable);
+            ++_requests;
+
+            if (_push && req.method() == http::verb::get
+                && std::string_view(req.target().data(), req.target().size()) == CHANGES_PATH) {
+                co_await streamChanges(stream, req);
+                co_return;
+            }
+
+            net::steady_timer timer(_ioc);
+            auto fault = pickFault();
+            if (fault == Fault::Reset) {
+                stream.next_layer().close();
+                co_return;
+            }
+            if (fault == Fault::Stall) {
+                timer.expires_after(STALL_TIME);
+                co_await timer.async_wait(net::use_awaitable);
+                co_return;
+            }
+
+            timer.expires_after(pickLatency());
+            co_await timer.async_wait(net::use_awaitable);
+
+            Response response;
+            if (fault == Fault::ServerError) {
+                response = status(req, http::status::internal_server_error);
+            } else if (fault == Fault::Unavailable) {
+                response = status(req, http::status::service_unavailable);
+            } else {
+                response = route(req);
+            }
+            co_await write(stream, response);
+            if (!response.keep_alive()) {
+                break;
+            }
+        }
+        co_await stream.async_shutdown(net::use_awaitable);
+    } catch (boost::system::system_error const& e) {
+        // the client hung up, expected at the end of every keep-alive connection
+        if (e.code() != http::error::end_of_stream && e.code() != net::error::eof) {
+            spdlog::debug("Mock server session ended: {}", e.what());
+        }
+    }
+}
+
+Task<void> MockServer::write(ssl::stream<tcp::socket>& stream, Response& response) {
+    http::response_serializer<http::string_body> serializer(response);
+    if (_profile.bandwidth == 0) {
+        co_await http::async_write(stream, serializer, net::use_awaitable);
+        co_return;
+    }
+
+    // chunks, each followed by the time it takes at `bandwidth`
+    serializer.limit(WRITE_CHUNK_SIZE);
+    net::steady_timer timer(_ioc);
+    while (!serializer.is_done()) {
+        auto written = co_await http::async_write_some(stream, serializer, net::use_awaitable);
+        timer.expires_after(std::chrono::microseconds(written * 1'000'000 / _profile.bandwidth));
+        co_await timer.async_wait(net::use_awaitable);
+    }
+}
+
+Task<void> MockServer::streamChanges(ssl::stream<tcp::socket>& stream, Request const& req) {
+    http::response<http::empty_body> response{http::status::ok, req.version()};
+    response.set(http::field::content_type, "text/event-stream");
+    response.set(http::field::cache_control, "no-cache");
+    response.chunked(true);
+    http::response_serializer<http::empty_body> serializer(response);
+    co_await http::async_write_header(stream, serializer, net::use_awaitable);
+
+    auto subscriber = std::make_shared<Subscriber>(_ioc);
+    subscriber->queue.push_back("retry: 3000\n\n");
+    // what the client missed since its last event
+    std::uint64_t lastId = 0;
+    if (auto last = req.find("Last-Event-ID"); last != req.end()) {
+        std::from_chars(last->value().data(), last->value().data() + last->value().size(), lastId);
+        for (auto const& [id, message] : _changeLog) {
+            if (id > lastId) {
+                subscriber->queue.push_back(message);
+            }
+        }
+    }
+    _subscribers.push_back(subscriber);
+    auto position = std::prev(_subscribers.end());
+
+    try {
+        while (true) {
+            while (!subscriber->queue.empty()) {
+                auto message = std::move(subscriber->queue.front());
+                subscriber->queue.pop_front();
+                co_await net::async_write(stream,
+                                          http::make_chunk(net::buffer(message)),
+                                          net::use_awaitable);
+            }
+            subscriber->wake.expires_after(HEARTBEAT_INTERVAL);
+            auto [ec] = co_await subscriber->wake.async_wait(net::as_tuple(net::use_awaitable));
+            if (!ec) {
+                subscriber->queue.push_back(": ping\n\n");
+            }
+        }
+    } catch (boost::system::system_error const& e) {
+        spdlog::debug("Change feed client left: {}", e.what());
+    }
+    _subscribers.erase(position);
+}
+
+Task<void> MockServer::changeLoop(std::chrono::milliseconds interval) {
+    net::steady_timer timer(_ioc);
+    while (true) {
+        timer.expires_after(interval);
+        co_await timer.async_wait(net::use_awaitable);
+        std::vector<std::size_t> movable;
+        for (std::size_t i = 0; i < _events.size(); ++i) {
+            if (_events[i].state == State::SigningUp || _events[i].state == State::Active) {
+                movable.push_back(i);
+            }
+        }
+        if (movable.empty()) {
+            continue;
+        }
+        auto index = movable[std::uniform_int_distribution<std::size_t>(0, movable.size() - 1)(
+            _random)];
+        auto& event = _events[index];
+        event.state = event.state == State::SigningUp ? State::Active : State::Completed;
+        changed(index);
+    }
+}
+
+void MockServer::changed(std::size_t index) {
+    ++_changes;
+    auto id = ++_lastChangeId;
+    auto message = std::format("id: {}\nevent: event\ndata: {}\n\n",
+                               id,
+                               nlohmann::json(_events[index]).dump());
+    _changeLog.emplace_back(id, message);
+    if (_changeLog.size() > CHANGE_LOG_SIZE) {
+        _changeLog.pop_front();
+    }
+    for (auto& subscriber : _subscribers) {
+        subscriber->queue.push_back(message);
+        subscriber->wake.cancel();
+    }
+}
+
+MockServer::Fault MockServer::pickFault() {
+    if (_profile.errorRate <= 0
+        || std::uniform_real_distribution<>(0, 1)(_random) >= _profile.errorRate) {
+        return Fault::None;
+    }
+    ++_injectedErrors;
+    switch (std::uniform_int_distribution<>(0, 3)(_random)) {
+    case 0:
+        return Fault::ServerError;
+    case 1:
+        return Fault::Unavailable;
+    case 2:
+        return Fault::Reset;
+    default:
+        return Fault::Stall;
+    }
+}
+
+std::chrono::milliseconds MockServer::pickLatency() {
+    if (_profile.jitter.count() <= 0) {
+        return _profile.latency;
+    }
+    std::uniform_int_distribution<long long> jitter(0, _profile.jitter.count());
+    return _profile.latency + std::chrono::milliseconds(jitter(_random));
+}
+
+MockServer::Response MockServer::route(Request const& req) {
+    std::string_view target(req.target().data(), req.target().size());
+    auto queryBegin = target.find('?');
+    auto path = target.substr(0, queryBegin);
+    auto params = parseQuery(queryBegin == std::string_view::npos
+                                 ? std::string_view{}
+                                 : target.substr(queryBegin + 1));
+    // the v1 api takes form parameters of POST requests in the body
+    if (req.method() == http::verb::post) {
+        params.merge(parseQuery(req.body()));
+    }
+
+    if (path.starts_with("/api/")) {
+        return evento(req, path.substr(4), params);
+    }
+    if (path.starts_with("/repos/")) {
+        return github(req, path.substr(6));
+    }
+    if (path.starts_with("/files/")) {
+        return file(req, path);
+    }
+    return status(req, http::status::not_found);
+}
+
+MockServer::Response MockServer::evento(Request const& req,
+                                        std::string_view path,
+                                        std::map<std::string, std::string> const& params) {
+    // api v1
+    if (path == "/event/conducting") {
+        return ok(req, eventsV1(eventsIn(State::Active)));
+    }
+    if (path == "/event/list") {
+        // with `departmentId` every event of the department, as the client asks for
+        if (auto id = intParam(params, "departmentId", 0);
+            id > 0 && static_cast<std::size_t>(id) <= _departments.size()) {
+            std::vector<EventEntity> events;
+            std::copy_if(_events.begin(),
+                         _events.end(),
+                         std::back_inserter(events),
+                         [&department = _departments[id - 1]](EventEntity const& event) {
+                             return event.larkDepartmentName == department;
+                         });
+            return ok(req, pageV1(events, params));
+        }
+        auto events = eventsIn(State::SigningUp);
+        auto active = eventsIn(State::Active);
+        events.insert(events.end(), active.begin(), active.end());
+        return ok(req, eventsV1(events));
+    }
+    if (path == "/event/history") {
+        return ok(req, pageV1(eventsIn(State::Completed), params));
+    }
+    if (path == "/user/subscribed") {
+        std::vector<EventEntity> subscribed;
+        std::copy_if(_events.begin(),
+                     _events.end(),
+                     std::back_inserter(subscribed),
+                     [](EventEntity const& event) { return event.isSubscribed; });
+        return ok(req, eventsV1(subscribed));
+    }
+    if (path == "/event/info") {
+        auto event = eventById(intParam(params, "eventId", 0));
+        return ok(req, event ? eventsV1({*event}).at(0) : nlohmann::json());
+    }
+    if (path == "/event/departments") {
+        auto departments = nlohmann::json::array();
+        for (std::size_t i = 0; i < _departments.size(); ++i) {
+            departments.push_back(DepartmentEntityV1{.id = static_cast<int>(i) + 1,
+                                                     .departmentName = _departments[i]});
+        }
+        return ok(req, departments);
+    }
+    if (path == "/slide/home/list") {
+        SlideEntityListV1 slides;
+        for (int i = 1; i <= 3; ++i) {
+            slides.slides.push_back({.id = i,
+                                     .title = std::format("slide {}", i),
+                                     .url = std::format("https://127.0.0.1:{}/files/slide/{}.png",
+                                                        _port,
+                                                        i),
+                                     .link = ""});
+        }
+        return ok(req, slides);
+    }
+    if (path == "/user/participate") {
+        auto event = eventById(intParam(params, "eventId", 0));
+        return ok(req,
+                  ParticipateEntity{.isRegistration = false,
+                                    .isParticipate = event && event->isCheckedIn,
+                                    .isSubscribe = event && event->isSubscribed});
+    }
+    if (path == "/feedback/user/info") {
+        auto it = _feedback.find(intParam(params, "eventId", 0));
+        if (it == _feedback.end()) {
+            return ok(req, nlohmann::json());
+        }
+        return ok(req,
+                  FeedbackEntityV1{.id = it->second.id,
+                                   .eventId = it->second.eventId,
+                                   .score = it->second.rating,
+                                   .content = it->second.feedback});
+    }
+    if (path == "/feedback/info" || path == "/event/checkIn" || path == "/user/subscribe") {
+        return ok(req, true);
+    }
+
+    // api v2
+    if (path == "/v2/client/event/query") {
+        std::vector<EventEntity> events;
+        if (auto id = intParam(params, "id", 0)) {
+            if (auto event = eventById(id)) {
+                events.push_back(*event);
+            }
+        } else if (auto department = params.find("larkDepartmentName");
+                   department != params.end()) {
+            std::copy_if(_events.begin(),
+                         _events.end(),
+                         std::back_inserter(events),
+                         [name = percentDecoded(department->second)](EventEntity const& event) {
+                             return event.larkDepartmentName == name;
+                         });
+        } else {
+            events = _events;
+        }
+        // of the user, as far as the mock has one
+        auto flag = [&params](char const* name) {
+            auto it = params.find(name);
+            return it != params.end() && it->second == "true";
+        };
+        if (flag("isSubscribed")) {
+            std::erase_if(events, [](EventEntity const& event) { return !event.isSubscribed; });
+        }
+        if (flag("isCheckedIn")) {
+            std::erase_if(events, [](EventEntity const& event) { return !event.isCheckedIn; });
+        }
+        auto page = std::max(intParam(params, "page", 1), 1);
+        auto size = std::max(intParam(params, "size", 10), 1);
+        auto begin = std::min(static_cast<std::size_t>((page - 1) * size), events.size());
+        auto end = std::min(begin + size, events.size());
+        return ok(req,
+                  EventQueryRes{
+                      .elements = {events.begin() + begin, events.begin() + end},
+                      .current = page,
+                      .total = static_cast<int>(events.size()),
+                  });
+    }
+    if (path == "/v2/client/lark/department") {
+        auto departments = nlohmann::json::array();
+        for (auto const& department : _departments) {
+            departments.push_back(DepartmentEntity{.id = department, .name = department});
+        }
+        return ok(req, departments);
+    }
+    if (path == "/v2/client/event/slide"
+        || (path.starts_with("/v2/client/event/") && path.ends_with("/slide"))) {
+        auto slides = nlohmann::json::array();
+        for (int i = 1; i <= 3; ++i) {
+            slides.push_back(SlideEntity{
+                .id = i,
+                .eventId = _events.empty() ? 0 : _events[i % _events.size()].id,
+                .url = std::format("https://127.0.0.1:{}/files/slide/{}.png", _port, i),
+                .link = ""});
+        }
+        return ok(req, slides);
+    }
+    if (path.starts_with("/v2/client/event/") && path.ends_with("/attachments")) {
+        return ok(req,
+                  AttachmentEntity{
+                      .id = 1,
+                      .eventId = 0,
+                      .url = std::format("https://127.0.0.1:{}/files/attachment.png", _port)});
+    }
+    if (path.starts_with("/v2/client/event/") && path.ends_with("/feedback")) {
+        if (req.method() != http::verb::get) {
+            return ok(req, true);
+        }
+        auto id = path.substr(std::string_view("/v2/client/event/").size());
+        int eventId = 0;
+        std::from_chars(id.data(), id.data() + id.size(), eventId);
+        auto it = _feedback.find(eventId);
+        return ok(req, it == _feedback.end() ? nlohmann::json() : nlohmann::json(it->second));
+    }
+    if (path.starts_with("/v2/client/event/")
+        && (path.ends_with("/subscribe") || path.ends_with("/check-in"))) {
+        auto id = path.substr(std::string_view("/v2/client/event/").size());
+        int eventId = 0;
+        std::from_chars(id.data(), id.data() + id.size(), eventId);
+        if (auto it = _eventIndex.find(eventId); it != _eventIndex.end()) {
+            auto& event = _events[it->second];
+            if (path.ends_with("/subscribe")) {
+                event.isSubscribed = params.contains("subscribe")
+                                     && params.at("subscribe") == "true";
+            } else {
+                event.isCheckedIn = true;
+            }
+            changed(it->second);
+        }
+        return ok(req, true);
+    }
+    return status(req, http::status::not_found);
+}
+
+MockServer::Response MockServer::github(Request const& req, std::string_view path) {
+    if (path == "/NJUPT-SAST/sast-evento/contributors") {
+        auto contributors = nlohmann::json::array();
+        for (int i = 1; i <= 12; ++i) {
+            contributors.push_back(ContributorEntity{
+                .login = std::format("contributor{}", i),
+                .avatar_url = std::format("https://127.0.0.1:{}/files/avatar/{}.png", _port, i),
+                .html_url = std::format("https://github.com/contributor{}", i),
+                .contributions = 100 / i});
+        }
+        return json(req, contributors);
+    }
+    if (path == "/NJUPT-SAST/sast-evento/releases/latest") {
+        return json(req,
+                    ReleaseEntity{.tag_name = "v0.0.0-mock",
+                                  .name = "mock release",
+                                  .body = "served by sast-evento-mock",
+                                  .html_url = "https://github.com/NJUPT-SAST/sast-evento/releases",
+                                  .published_at = "2024-10-01T00:00:00Z"});
+    }
+    return status(req, http::status::not_found);
+}
+
+MockServer::Response MockServer::file(Request const& req, std::string_view path) {
+    // the png signature padded to a typical image size, enough for `guessImageExtByBytes`
+    std::string body(32 * 1024, '\0');
+    constexpr unsigned char PNG_SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    std::copy(std::begin(PNG_SIGNATURE), std::end(PNG_SIGNATURE), body.begin());
+
+    Response response{http::status::ok, req.version()};
+    response.set(http::field::content_type, "image/png");
+    response.set(http::field::etag, std::format("\"{}\"", std::hash<std::string_view>{}(path)));
+    response.keep_alive(req.keep_alive());
+    response.body() = std::move(body);
+    response.prepare_payload();
+    return response;
+}
+
+MockServer::Response MockServer::json(Request const& req, nlohmann::json const& body) const {
+    Response response{http::status::ok, req.version()};
+    response.set(http::field::content_type, "application/json");
+    response.keep_alive(req.keep_alive());
+    response.body() = body.dump();
+    response.prepare_payload();
+    return response;
+}
+
+MockServer::Response MockServer::ok(Request const& req, nlohmann::json data) const {
+    // v1 reports errors in `errMsg`, v2 in `message`
+    return json(req,
+                {{"success", true},
+                 {"errCode", 0},
+                 {"errMsg", ""},
+                 {"message", ""},
+                 {"data", std::move(data)}});
+}
+
+MockServer::Response MockServer::status(Request const& req, http::status code) const {
+    Response response{code, req.version()};
+    response.keep_alive(req.keep_alive());
+    response.prepare_payload();
+    return response;
+}
+
+nlohmann::json MockServer::eventsV1(std::vector<EventEntity> const& events) const {
+    auto list = nlohmann::json::array();
+    for (auto const& event : events) {
+        auto department = std::find(_departments.begin(),
+                                    _departments.end(),
+                                    event.larkDepartmentName);
+        list.push_back(EventEntityV1{
+            .id = event.id,
+            .title = event.summary,
+            .description = event.description,
+            .gmtEventStart = event.start,
+            .gmtEventEnd = event.end,
+            .location = event.location,
+            .tag = event.tag,
+            .state = toV1(event.state),
+            .departments = {{.id = static_cast<int>(department - _departments.begin()) + 1,
+                             .departmentName = event.larkDepartmentName}},
+        });
+    }
+    return list;
+}
+
+nlohmann::json MockServer::pageV1(std::vector<EventEntity> const& events,
+                                  std::map<std::string, std::string> const& params) const {
+    // without `page`, every event as the v1 backend does
+    if (!params.contains("page")) {
+        return eventsV1(events);
+    }
+    auto page = std::max(intParam(params, "page", 1), 1);
+    auto size = std::max(intParam(params, "size", 10), 1);
+    auto begin = std::min(static_cast<std::size_t>((page - 1) * size), events.size());
+    auto end = std::min(begin + size, events.size());
+    return {
+        {"elements", eventsV1({events.begin() + begin, events.begin() + end})},
+        {"current", page},
+        {"total", static_cast<int>(events.size())},
+    };
+}
+
+EventEntity const* MockServer::eventById(int id) const {
+    auto it = _eventIndex.find(id);
+    return it == _eventIndex.end() ? nullptr : &_events[it->second];
+}
+
+std::vector<EventEntity> MockServer::eventsIn(State state) const {
+    std::vector<EventEntity> events;
+    std::copy_if(_events.begin(),
+                 _events.end(),
+                 std::back_inserter(events),
+                 [state](EventEntity const& event) { return event.state == state; });
+    return events;
+}
+
+} // namespace evento::bench
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Corpus.h"
+#include <Infrastructure/Network/ResponseStruct.h>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast.hpp>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace evento::bench {
+
+namespace beast = boost::beast;   // from <boost/beast.hpp>
+namespace http = beast::http;     // from <boost/beast/http.hpp>
+namespace net = boost::asio;      // from <boost/asio.hpp>
+namespace ssl = boost::asio::ssl; // from <boost/asio/ssl.hpp>
+
+template<typename T>
+using Task = net::awaitable<T>;
+
+// how the mock answers, applied to every response
+struct MockProfile {
+    std::chrono::milliseconds latency{0}; // before the response header
+    std::chrono::milliseconds jitter{0};  // up to this much on top of `latency`, uniformly
+    std::size_t bandwidth = 0;            // response bytes per second, 0 for unlimited
+    // share of requests that fail, evenly split into 500, 503, a reset connection
+    // and a connection that stalls until the client gives up
+    double errorRate = 0;
+
+    // "lan", "wifi", "mobile" or "flaky"
+    static std::optional<MockProfile> named(std::string_view name);
+};
+
+// Plays the Evento backend (API v1 and v2) and the GitHub API over HTTPS on loopback,
+// with a self-signed certificate made at start, so it runs without network or files.
+// The events come from the benchmark corpus or a generated dataset, see `corpus/generate.py`.
+// Subscribing and checking in change them, and every change is pushed to the clients of
+// the change feed, see `NetworkClient::watchChanges`.
+//
+// All members but the counters must be called in the thread running `ioc`.
+class MockServer {
+public:
+    MockServer(net::io_context& ioc, MockProfile profile, std::size_t events = 100);
+    MockServer(net::io_context& ioc, MockProfile profile, Dataset dataset);
+
+    // listen on 127.0.0.1:`port`, 0 for any free port, returns the port
+    unsigned short listen(unsigned short port = 0);
+
+    // for `EVENTO_API_GATEWAY` and `EVENTO_GITHUB_GATEWAY`
+    [[nodiscard]] std::string eventoGateway() const;
+    [[nodiscard]] std::string githubGateway() const;
+
+    // without it the change feed is 404, as on a backend that has none
+    void setPush(bool enabled) { _push = enabled; }
+    // move a random event along, signing up to active to completed, every `interval`
+    void changeEvery(std::chrono::milliseconds interval);
+
+    [[nodiscard]] std::uint64_t requests() const { return _requests; }
+    [[nodiscard]] std::uint64_t injectedErrors() const { return _injectedErrors; }
+    [[nodiscard]] std::uint64_t changes() const { return _changes; }
+
+private:
+    using tcp = net::ip::tcp;
+    using Request = http::request<http::string_body>;
+    using Response = http::response<http::string_body>;
+
+    enum class Fault {
+        None,
+        ServerError,
+        Unavailable,
+        Reset,
+        Stall,
+    };
+
+    Task<void> accept();
+    Task<void> session(tcp::socket socket);
+    Task<void> write(ssl::stream<tcp::socket>& stream, Response& response);
+    // the change feed, until the client hangs up
+    Task<void> streamChanges(ssl::stream<tcp::socket>& stream, Request const& req);
+    Task<void> changeLoop(std::chrono::milliseconds interval);
+    // record the change of `_events[index]` and push it
+    void changed(std::size_t index);
+
+    Fault pickFault();
+    std::chrono::milliseconds pickLatency();
+
+    Response route(Request const& req);
+    Response evento(Request const& req,
+                    std::string_view path,
+                    std::map<std::string, std::string> const& params);
+    Response github(Request const& req, std::string_view path);
+    Response file(Request const& req, std::string_view path);
+
+    Response json(Request const& req, nlohmann::json const& body) const;
+    // the envelope of the Evento backend around `data`
+    Response ok(Request const& req, nlohmann::json data) const;
+    Response status(Request const& req, http::status code) const;
+
+    [[nodiscard]] nlohmann::json eventsV1(std::vector<EventEntity> const& events) const;
+    // a page of `events` for the v1 list endpoints given `page` and `size`, see `NetworkClient`
+    [[nodiscard]] nlohmann::json pageV1(std::vector<EventEntity> const& events,
+                                        std::map<std::string, std::string> const& params) const;
+    [[nodiscard]] std::vector<EventEntity> eventsIn(State state) const;
+    [[nodiscard]] EventEntity const* eventById(int id) const;
+
+    net::io_context& _ioc;
+    ssl::context _ctx;
+    std::optional<tcp::acceptor> _acceptor;
+    unsigned short _port = 0;
+    MockProfile _profile;
+    std::mt19937 _random{std::random_device{}()};
+
+    std::vector<EventEntity> _events;
+    std::unordered_map<int, std::size_t> _eventIndex; // id -> index in `_events`
+    std::vector<std::string> _departments;
+    std::unordered_map<int, FeedbackEntity> _feedback; // by event id
+
+    // a client of the change feed, woken by cancelling `wake`
+    struct Subscriber {
+        explicit Subscriber(net::io_context& ioc)
+            : wake(ioc) {}
+        std::deque<std::string> queue;
+        net::steady_timer wake;
+    };
+    bool _push = true;
+    std::list<std::shared_ptr<Subscriber>> _subscribers;
+    std::deque<std::pair<std::uint64_t, std::string>> _changeLog; // for `Last-Event-ID`
+    std::uint64_t _lastChangeId = 0;
+
+    std::atomic<std::uint64_t> _requests = 0;
+    std::atomic<std::uint64_t> _injectedErrors = 0;
+    std::atomic<std::uint64_t> _changes = 0;
+};
+
+} // namespace evento::bench
@@ -0,0 +1,123 @@
+#include "MockServer.h"
+#include <boost/asio/signal_set.hpp>
+#include <charconv>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <string_view>
+
+namespace {
+
+using namespace evento::bench;
+
+constexpr const char USAGE[] =
+    R"(usage: sast-evento-mock [options]
+  --port <n>            listen on 127.0.0.1:<n>, default 8443, 0 for any free port
+  --profile <name>      lan, wifi, mobile or flaky, the options below override it
+  --latency <ms>        before each response
+  --jitter <ms>         up to this much random extra latency
+  --bandwidth <KiB/s>   response throughput, 0 for unlimited
+  --error-rate <0..1>   share of requests failing with 500, 503, a reset or a stall
+  --events <n>          events to serve, the corpus is repeated as needed, default 100
+  --dataset <dir>       serve a dataset of `corpus/generate.py --dataset` instead of the corpus
+  --push <on|off>       serve the change feed, default on, off answers it with 404
+  --change-every <ms>   move a random event to its next state and push it, 0 for never
+)";
+
+template<typename T>
+bool parseNumber(std::string_view text, T& value) {
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MockProfile profile;
+    unsigned short port = 8443;
+    std::size_t events = 100;
+    std::optional<std::filesystem::path> dataset;
+    bool push = true;
+    long long changeEvery = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view option = argv[i];
+        if (option == "--help" || option == "-h" || i + 1 >= argc) {
+            std::fputs(USAGE, option == "--help" || option == "-h" ? stdout : stderr);
+            return option == "--help" || option == "-h" ? 0 : 1;
+        }
+        std::string_view value = argv[++i];
+        long long number = 0;
+        double rate = 0;
+        bool valid = true;
+        if (option == "--profile") {
+            auto named = MockProfile::named(value);
+            valid = named.has_value();
+            if (valid) {
+                profile = *named;
+            }
+        } else if (option == "--port") {
+            valid = parseNumber(value, port);
+        } else if (option == "--latency") {
+            valid = parseNumber(value, number);
+            profile.latency = std::chrono::milliseconds(number);
+        } else if (option == "--jitter") {
+            valid = parseNumber(value, number);
+            profile.jitter = std::chrono::milliseconds(number);
+        } else if (option == "--bandwidth") {
+            valid = parseNumber(value, number);
+            profile.bandwidth = static_cast<std::size_t>(number) * 1024;
+        } else if (option == "--error-rate") {
+            valid = parseNumber(value, rate) && rate >= 0 && rate <= 1;
+            profile.errorRate = rate;
+        } else if (option == "--events") {
+            valid = parseNumber(value, events) && events > 0;
+        } else if (option == "--dataset") {
+            dataset = value;
+        } else if (option == "--push") {
+            valid = value == "on" || value == "off";
+            push = value == "on";
+        } else if (option == "--change-every") {
+            valid = parseNumber(value, changeEvery) && changeEvery >= 0;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            std::fprintf(stderr, "invalid option: %s %s\n%s", argv[i - 1], argv[i], USAGE);
+            return 1;
+        }
+    }
+
+    net::io_context ioc;
+    std::optional<MockServer> server;
+    try {
+        if (dataset) {
+            server.emplace(ioc, profile, loadDataset(*dataset));
+        } else {
+            server.emplace(ioc, profile, events);
+        }
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    server->setPush(push);
+    if (changeEvery > 0) {
+        server->changeEvery(std::chrono::milliseconds(changeEvery));
+    }
+    server->listen(port);
+    std::printf("export EVENTO_API_GATEWAY=%s\nexport EVENTO_GITHUB_GATEWAY=%s\n",
+                server->eventoGateway().c_str(),
+                server->githubGateway().c_str());
+    std::fflush(stdout);
+
+    net::signal_set signals(ioc, SIGINT, SIGTERM);
+    signals.async_wait([&](auto, auto) { ioc.stop(); });
+    ioc.run();
+
+    spdlog::info("Served {} requests, {} with injected errors, pushed {} changes",
+                 server->requests(),
+                 server->injectedErrors(),
+                 server->changes());
+}
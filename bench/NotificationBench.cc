@@ -0,0 +1,62 @@
+#include <Infrastructure/IPC/NotificationScheduler.h>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+
+namespace {
+
+using namespace evento;
+using namespace std::chrono_literals;
+
+// what `MyEventPage` does every minute: the same events scheduled again,
+// the counters must not grow with the iterations, the run fails if they do
+void BM_NotificationRefresh(benchmark::State& state) {
+    net::io_context ioc;
+    auto scheduler = NotificationScheduler::create(ioc, [](std::string) {}, std::nullopt);
+    auto start = NotificationScheduler::Clock::now() + 1h;
+    auto events = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        for (int id = 0; id < events; ++id) {
+            scheduler->schedule(id, "活动还有 15 分钟就要开始了", start + id * 1min);
+        }
+        ioc.poll();
+    }
+    auto stats = scheduler->stats();
+    state.counters["pending"] = static_cast<double>(stats.pending);
+    state.counters["heap"] = static_cast<double>(stats.heapSize);
+    state.counters["timers"] = static_cast<double>(stats.armedTimers);
+    state.SetItemsProcessed(state.iterations() * events);
+    if (stats.armedTimers > 1) {
+        state.SkipWithError("more than one timer armed");
+    } else if (stats.pending != static_cast<std::size_t>(events)
+               || stats.heapSize != static_cast<std::size_t>(events)) {
+        state.SkipWithError("refreshing the same events grew the scheduler");
+    }
+}
+BENCHMARK(BM_NotificationRefresh)->RangeMultiplier(8)->Range(8, 4096);
+
+// every refresh moves one event, the worst case for the heap
+void BM_NotificationReschedule(benchmark::State& state) {
+    net::io_context ioc;
+    auto scheduler = NotificationScheduler::create(ioc, [](std::string) {}, std::nullopt);
+    auto start = NotificationScheduler::Clock::now() + 1h;
+    auto events = static_cast<int>(state.range(0));
+    for (int id = 0; id < events; ++id) {
+        scheduler->schedule(id, "活动结束了", start + id * 1min);
+    }
+    int round = 0;
+    for (auto _ : state) {
+        scheduler->schedule(round % events, "活动结束了", start + (round % 7) * 1s);
+        ioc.poll();
+        ++round;
+    }
+    auto stats = scheduler->stats();
+    state.counters["heap"] = static_cast<double>(stats.heapSize);
+    state.counters["timers"] = static_cast<double>(stats.armedTimers);
+    if (stats.armedTimers > 1) {
+        state.SkipWithError("more than one timer armed");
+    }
+}
+BENCHMARK(BM_NotificationReschedule)->RangeMultiplier(8)->Range(8, 4096);
+
+} // namespace
@@ -0,0 +1,45 @@
+#include "Corpus.h"
+#include <Infrastructure/Network/ResponseStruct.h>
+#include <Infrastructure/Utils/Fingerprint.h>
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+using namespace evento;
+
+// events in the response body
+void BM_ParseEventQueryRes(benchmark::State& state) {
+    auto const& payload = bench::eventQueryPayload(state.range(0));
+    for (auto _ : state) {
+        auto result = nlohmann::json::parse(payload).get<EventQueryRes>();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseEventQueryRes)->RangeMultiplier(10)->Range(10, 100'000);
+
+// the same without `from_json`, to tell the two apart
+void BM_ParseJsonOnly(benchmark::State& state) {
+    auto const& payload = bench::eventQueryPayload(state.range(0));
+    for (auto _ : state) {
+        auto json = nlohmann::json::parse(payload);
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_ParseJsonOnly)->RangeMultiplier(10)->Range(10, 100'000);
+
+// what an unchanged response costs instead of the above
+void BM_FingerprintOnly(benchmark::State& state) {
+    auto const& payload = bench::eventQueryPayload(state.range(0));
+    for (auto _ : state) {
+        auto fingerprint = fingerprintOf(payload);
+        benchmark::DoNotOptimize(fingerprint);
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_FingerprintOnly)->RangeMultiplier(10)->Range(10, 100'000);
+
+} // namespace
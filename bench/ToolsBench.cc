@@ -0,0 +1,41 @@
+#include "Corpus.h"
+#include <Infrastructure/Utils/Tools.h>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace evento;
+
+void BM_ParseIso8601Utc(benchmark::State& state) {
+    std::vector<std::string> dates;
+    for (auto const& event : bench::corpusEvents()) {
+        dates.push_back(event["start"].get<std::string>());
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseIso8601Utc(dates[i++ % dates.size()].c_str()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseIso8601Utc);
+
+void BM_GuessImageExtByBytes(benchmark::State& state) {
+    std::array<std::array<unsigned char, 4>, 5> magics{{
+        {0xff, 0xd8, 0xff, 0xe0}, // jpg
+        {0x89, 0x50, 0x4e, 0x47}, // png
+        {0x47, 0x49, 0x46, 0x38}, // gif
+        {0x42, 0x4d, 0x36, 0x00}, // bmp
+        {0x52, 0x49, 0x46, 0x46}, // webp, unknown
+    }};
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(guessImageExtByBytes(magics[i++ % magics.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GuessImageExtByBytes);
+
+} // namespace
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+# Writes `events.json`, the payload of the benchmarks: an `EventQueryRes` with the shape of the
+# Evento API v2 and dates in the format `parseIso8601Utc` expects while `EVENTO_API_V1` is set.
+# Deterministic, rerun it after changing the generator and commit the output.
+#
+# With `--dataset <dir> --events <n>` it writes a large dataset for `sast-evento-mock --dataset`
+# instead: `events.json`, `departments.json` and `feedback.json`, not meant to be committed.
+
+import argparse
+import json
+import random
+from datetime import datetime, timedelta
+from pathlib import Path
+
+COUNT = 100
+
+TAGS = ["讲座", "比赛", "分享会", "工作坊", "招新"]
+DEPARTMENTS = ["软件研发中心", "C++ 组", "前端组", "后端组", "运维组", "设计组", "产品组"]
+STATES = ["SIGNING_UP", "ACTIVE", "COMPLETED", "CANCELLED"]
+COLLEGES = ["计算机学院", "通信学院", "电子学院", "自动化学院", "理学院", "管理学院", "外国语学院",
+            "艺术学院"]
+FEEDBACK = ["内容很充实", "讲得很清楚", "时间有点紧", "希望多一些实操", "场地有点小", "期待下一次"]
+WORDS = ["现代", "C++", "协程", "网络", "缓存", "性能", "调试", "构建", "界面", "异步",
+         "Slint", "Boost", "Asio", "内存", "模板", "并发"]
+
+
+def sentence(rng, low, high):
+    return "".join(rng.choice(WORDS) for _ in range(rng.randint(low, high)))
+
+
+def event(rng, index, base, departments=DEPARTMENTS, spread=60, now=None):
+    start = base + timedelta(days=rng.randint(0, spread), hours=rng.randint(8, 20))
+    end = start + timedelta(hours=rng.randint(1, 4))
+    entity = {
+        "id": 1000 + index,
+        "summary": sentence(rng, 2, 6),
+        "description": sentence(rng, 20, 120),
+        "start": start.strftime("%Y-%m-%d %H:%M:%S"),
+        "end": end.strftime("%Y-%m-%d %H:%M:%S"),
+        "location": rng.choice([None, "教 4-203", "图书馆报告厅", "线上"]),
+        "tag": rng.choice(TAGS),
+        "larkMeetingRoomName": rng.choice([None, "SAST 会议室"]),
+        "larkDepartmentName": rng.choice(departments),
+        "state": rng.choice(STATES),
+        "isSubscribed": rng.random() < 0.3,
+        "isCheckedIn": rng.random() < 0.1,
+    }
+    # a dataset follows the calendar, the corpus keeps its random states
+    if now is not None:
+        if rng.random() < 0.03:
+            entity["state"] = "CANCELLED"
+        elif end < now:
+            entity["state"] = "COMPLETED"
+        elif start <= now:
+            entity["state"] = "ACTIVE"
+        else:
+            entity["state"] = "SIGNING_UP"
+    return entity
+
+
+# every college has every group, numbered branches once those run out
+def department_names(count):
+    names = [college + group for college in COLLEGES for group in DEPARTMENTS]
+    branch = 2
+    while len(names) < count:
+        names += [f"{name} {branch} 分部" for name in names[:len(COLLEGES) * len(DEPARTMENTS)]]
+        branch += 1
+    return names[:count]
+
+
+def write_json(path, payload, indent=None):
+    separators = None if indent else (",", ":")
+    text = json.dumps(payload, ensure_ascii=False, indent=indent, separators=separators)
+    path.write_text(text + "\n", encoding="utf-8")
+
+
+def write_corpus():
+    rng = random.Random(20241019)
+    base = datetime(2024, 10, 1)
+    payload = {
+        "elements": [event(rng, i, base) for i in range(COUNT)],
+        "current": 1,
+        "total": COUNT,
+    }
+    write_json(Path(__file__).with_name("events.json"), payload, indent=1)
+
+
+# a couple of hundred events per department, most of them in the past, as in production
+def write_dataset(directory, count, seed):
+    rng = random.Random(seed)
+    now = datetime(2024, 10, 1)
+    spread = min(max(60, count // 20), 5 * 365)
+    base = now - timedelta(days=spread * 9 // 10)
+    departments = department_names(max(len(DEPARTMENTS), count // 200))
+    events = [event(rng, i, base, departments, spread, now) for i in range(count)]
+    events.sort(key=lambda entity: entity["start"], reverse=True)
+    feedback = []
+    for entity in events:
+        if entity["state"] == "COMPLETED" and rng.random() < 0.3:
+            feedback.append({
+                "id": len(feedback) + 1,
+                "linkId": 1,
+                "eventId": entity["id"],
+                "rating": rng.randint(1, 5),
+                "feedback": rng.choice([None, rng.choice(FEEDBACK) + sentence(rng, 0, 8)]),
+            })
+
+    directory.mkdir(parents=True, exist_ok=True)
+    write_json(directory / "events.json", {"elements": events, "current": 1, "total": count})
+    write_json(directory / "departments.json", [{"id": name, "name": name} for name in departments])
+    write_json(directory / "feedback.json", feedback)
+    print(f"{count} events, {len(departments)} departments, {len(feedback)} feedback in {directory}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the benchmark corpus or a dataset.")
+    parser.add_argument("--dataset", type=Path, help="write a dataset into this directory")
+    parser.add_argument("--events", type=int, default=1000, help="events of the dataset")
+    parser.add_argument("--seed", type=int, default=20241019, help="seed of the dataset")
+    args = parser.parse_args()
+    if args.dataset is None:
+        write_corpus()
+    else:
+        write_dataset(args.dataset, args.events, args.seed)
+
+
+if __name__ == "__main__":
+    main()
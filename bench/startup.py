@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Cold and warm start benchmark of the app: runs it repeatedly with `EVENTO_STARTUP_REPORT` set,
+# so that it quits once the first frame and the first events are shown, and prints the median
+# time of every startup phase, see `StartupTimeline`.
+#
+# - cold: every run starts with an empty disk cache, with `--drop-caches` (Linux, root) the OS
+#   page cache is dropped too, so that the binary and its libraries are read from disk again
+# - warm: the runs share a disk cache, filled by one run that is not counted
+#
+# Runs against whatever `EVENTO_API_GATEWAY` points to, e.g. `sast-evento-mock`, or replays a
+# traffic archive with `EVENTO_TRAFFIC_REPLAY`. Linux only, the disk cache is `XDG_CACHE_HOME`.
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+
+def drop_page_cache():
+    subprocess.run(["sync"], check=True)
+    Path("/proc/sys/vm/drop_caches").write_text("3\n")
+
+
+def run_once(app, cache_home, timeout):
+    with tempfile.TemporaryDirectory() as scratch:
+        report = Path(scratch) / "startup.json"
+        env = dict(os.environ, XDG_CACHE_HOME=str(cache_home), EVENTO_STARTUP_REPORT=str(report))
+        try:
+            subprocess.run([app], env=env, timeout=timeout, check=False,
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        except subprocess.TimeoutExpired:
+            return None
+        if not report.exists():
+            return None
+        return {phase["name"]: phase for phase in json.loads(report.read_text())["phases"]}
+
+
+def run_series(app, runs, cold, drop_caches, timeout):
+    reports = []
+    with tempfile.TemporaryDirectory() as shared:
+        if not cold:
+            run_once(app, shared, timeout)
+        for _ in range(runs):
+            if cold and drop_caches:
+                drop_page_cache()
+            if cold:
+                with tempfile.TemporaryDirectory() as fresh:
+                    report = run_once(app, fresh, timeout)
+            else:
+                report = run_once(app, shared, timeout)
+            if report is None:
+                print("run timed out or wrote no report", file=sys.stderr)
+                continue
+            reports.append(report)
+    return reports
+
+
+def medians(reports, key):
+    # phases in the order of the first report, missing ones are left out
+    names = list(reports[0]) if reports else []
+    return {name: statistics.median(report[name][key] for report in reports if name in report)
+            for name in names}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="cold and warm start benchmark of sast-evento")
+    parser.add_argument("app", help="path to the sast-evento executable")
+    parser.add_argument("--runs", type=int, default=5, help="runs per mode, default 5")
+    parser.add_argument("--mode", choices=["cold", "warm", "both"], default="both")
+    parser.add_argument("--drop-caches", action="store_true",
+                        help="drop the OS page cache before each cold run, needs root")
+    parser.add_argument("--timeout", type=float, default=60, help="seconds per run, default 60")
+    parser.add_argument("--json", action="store_true", help="print the medians as JSON")
+    args = parser.parse_args()
+
+    results = {}
+    for mode in ["cold", "warm"]:
+        if args.mode in (mode, "both"):
+            reports = run_series(args.app, args.runs, mode == "cold", args.drop_caches,
+                                 args.timeout)
+            results[mode] = {"runs": len(reports),
+                             "durationMs": medians(reports, "durationMs"),
+                             "atMs": medians(reports, "atMs")}
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+    modes = list(results)
+    names = []
+    for mode in modes:
+        names += [name for name in results[mode]["durationMs"] if name not in names]
+    print(f"{'phase':<16}" + "".join(f"{mode + ' +ms':>12}{mode + ' @ms':>12}" for mode in modes))
+    for name in names:
+        row = f"{name:<16}"
+        for mode in modes:
+            duration = results[mode]["durationMs"].get(name)
+            at = results[mode]["atMs"].get(name)
+            row += f"{duration:>12.1f}{at:>12.1f}" if duration is not None else f"{'-':>12}{'-':>12}"
+        print(row)
+    print("medians of " + ", ".join(f"{results[mode]['runs']} {mode}" for mode in modes)
+          + " runs")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,280 @@
+#include <Infrastructure/Network/NetworkClient.h>
+#include <Infrastructure/Utils/Diagnostics.h>
+#include <algorithm>
+#include <boost/asio/co_spawn.hpp>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Headless front-end of `NetworkClient`: every command prints one JSON document to stdout,
+// logs and the `--profile` report go to stderr.
+
+namespace {
+
+using namespace evento;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+constexpr const char USAGE[] =
+    R"(usage: sast-evento-cli [--profile] [--pretty] [--verbose] <command> [options]
+commands:
+  events [--active | --latest | --participated | --subscribed]   default --active
+  history [--pages <n>] [--size <n>]   the first n pages, default 1 page of 10
+  event <id>
+  departments
+  slides [--event <id>]                home slides by default
+  prefetch [--pages <n>]               fill the disk cache as the app would on start
+  cache stats                          usage of the disk cache
+  cache gc [--max-age-days <n>]        remove files untouched for n days, default 30
+options:
+  --profile   print the diagnostics, e.g. per-endpoint latencies, to stderr
+  --pretty    indent the JSON output
+  --verbose   log requests to stderr
+EVENTO_TOKEN is used as access token, for --participated and --subscribed.
+EVENTO_API_GATEWAY, EVENTO_HEDGING, EVENTO_TRAFFIC_RECORD and EVENTO_TRAFFIC_REPLAY apply as for
+the app.
+)";
+
+// exit codes
+constexpr int OK = 0;
+constexpr int USAGE_ERROR = 1;
+constexpr int REQUEST_ERROR = 2;
+constexpr int INTERNAL_ERROR = 3; // the command threw
+
+struct Options {
+    std::vector<std::string_view> args; // command and its options
+    bool profile = false;
+    bool pretty = false;
+    bool verbose = false;
+
+    // value following `--name`, if given
+    [[nodiscard]] std::optional<std::string_view> value(std::string_view name) const {
+        for (std::size_t i = 0; i + 1 < args.size(); ++i) {
+            if (args[i] == name) {
+                return args[i + 1];
+            }
+        }
+        return std::nullopt;
+    }
+    [[nodiscard]] bool flag(std::string_view name) const {
+        return std::find(args.begin(), args.end(), name) != args.end();
+    }
+};
+
+template<typename T>
+std::optional<T> parseNumber(std::optional<std::string_view> text, T fallback) {
+    if (!text) {
+        return fallback;
+    }
+    T value{};
+    auto [end, ec] = std::from_chars(text->data(), text->data() + text->size(), value);
+    if (ec != std::errc{} || end != text->data() + text->size() || value <= 0) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+json usageOf(NetworkClient::DiskCacheUsage const& usage) {
+    return {{"files", usage.files}, {"bytes", usage.bytes}};
+}
+
+// `data` of a successful `result`, or a JSON error
+template<typename T>
+std::pair<json, bool> toJson(evento::Result<T> const& result) {
+    if (result.isErr()) {
+        return {{{"error", result.unwrapErr().what()}}, false};
+    }
+    return {json(result.unwrap()), true};
+}
+
+Task<std::pair<json, bool>> events(Options const& options) {
+    auto client = networkClient();
+    if (options.flag("--latest")) {
+        co_return toJson(co_await client->getLatestEventList(0s));
+    }
+    if (options.flag("--participated")) {
+        co_return toJson(co_await client->getParticipatedEvent(0s));
+    }
+    if (options.flag("--subscribed")) {
+        co_return toJson(co_await client->getSubscribedEvent(0s));
+    }
+    co_return toJson(co_await client->getActiveEventList(0s));
+}
+
+Task<std::pair<json, bool>> history(int pages, int size) {
+    auto output = json::array();
+    for (int page = 1; page <= pages; ++page) {
+        auto [data, ok] = toJson(co_await networkClient()->getHistoryEventList(page, size, 0s));
+        if (!ok) {
+            co_return std::pair{data, false};
+        }
+        output.push_back(std::move(data));
+    }
+    co_return std::pair{output, true};
+}
+
+// what the app loads on start, with the home slide images downloaded into the disk cache
+Task<std::pair<json, bool>> prefetch(int pages) {
+    auto client = networkClient();
+    auto start = Clock::now();
+    int requests = 0;
+    int files = 0;
+    auto failures = json::array();
+    auto note = [&](std::string_view what, auto const& result) {
+        ++requests;
+        if (result.isErr()) {
+            failures.push_back({{"request", what}, {"error", result.unwrapErr().what()}});
+        }
+    };
+
+    note("active events", co_await client->getActiveEventList(0s));
+    note("latest events", co_await client->getLatestEventList(0s));
+    for (int page = 1; page <= pages; ++page) {
+        note(std::format("history page {}", page), co_await client->getHistoryEventList(page));
+    }
+    note("departments", co_await client->getDepartmentList(0s));
+    auto slides = co_await client->getHomeSlide(0s);
+    note("home slides", slides);
+    if (slides.isOk()) {
+        for (auto const& slide : slides.unwrap()) {
+            auto file = co_await client->getFile(slide.url);
+            note(slide.url, file);
+            files += file.isOk();
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+    co_return std::pair{json{{"requests", requests},
+                             {"files", files},
+                             {"failures", failures},
+                             {"elapsedMs", elapsed.count()},
+                             {"disk", usageOf(NetworkClient::diskCacheUsage())}},
+                        failures.empty()};
+}
+
+Task<int> run(Options const& options) {
+    auto const& args = options.args;
+    auto command = args.empty() ? std::string_view{} : args[0];
+    std::pair<json, bool> output;
+
+    if (command == "events") {
+        output = co_await events(options);
+    } else if (command == "history") {
+        auto pages = parseNumber(options.value("--pages"), 1);
+        auto size = parseNumber(options.value("--size"), 10);
+        if (!pages || !size) {
+            co_return USAGE_ERROR;
+        }
+        output = co_await history(*pages, *size);
+    } else if (command == "event" && args.size() > 1) {
+        auto id = parseNumber(std::optional(args[1]), 0);
+        if (!id) {
+            co_return USAGE_ERROR;
+        }
+        output = toJson(co_await networkClient()->getEventById(*id));
+    } else if (command == "departments") {
+        output = toJson(co_await networkClient()->getDepartmentList(0s));
+    } else if (command == "slides") {
+        if (auto event = options.value("--event")) {
+            auto id = parseNumber(event, 0);
+            if (!id) {
+                co_return USAGE_ERROR;
+            }
+            output = toJson(co_await networkClient()->getEventSlide(*id, 0s));
+        } else {
+            output = toJson(co_await networkClient()->getHomeSlide(0s));
+        }
+    } else if (command == "prefetch") {
+        auto pages = parseNumber(options.value("--pages"), 1);
+        if (!pages) {
+            co_return USAGE_ERROR;
+        }
+        output = co_await prefetch(*pages);
+    } else if (command == "cache" && args.size() > 1 && args[1] == "stats") {
+        output = {{{"dir", CacheManager::cacheDir().value_or("").string()},
+                   {"disk", usageOf(NetworkClient::diskCacheUsage())}},
+                  true};
+    } else if (command == "cache" && args.size() > 1 && args[1] == "gc") {
+        auto days = parseNumber(options.value("--max-age-days"), 30);
+        if (!days) {
+            co_return USAGE_ERROR;
+        }
+        auto removed = NetworkClient::collectGarbage(std::chrono::days(*days));
+        output = {{{"removed", usageOf(removed)},
+                   {"disk", usageOf(NetworkClient::diskCacheUsage())}},
+                  true};
+    } else {
+        co_return USAGE_ERROR;
+    }
+
+    std::puts(output.first.dump(options.pretty ? 2 : -1).c_str());
+    co_return output.second ? OK : REQUEST_ERROR;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::fputs(USAGE, stdout);
+            return OK;
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--pretty") {
+            options.pretty = true;
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            options.args.push_back(arg);
+        }
+    }
+
+    // stdout is for the JSON output only
+    spdlog::set_default_logger(spdlog::stderr_color_mt("cli"));
+    spdlog::set_level(options.verbose ? spdlog::level::info : spdlog::level::warn);
+
+    if (auto token = std::getenv("EVENTO_TOKEN"); token && *token) {
+        networkClient()->tokenBytes = token;
+    }
+
+    // outlives the connections pooled by the `networkClient()` singleton
+    static net::io_context ioc;
+    int code = USAGE_ERROR;
+    net::co_spawn(ioc, run(options), [&code](std::exception_ptr e, int result) {
+        if (!e) {
+            code = result;
+            return;
+        }
+        // thrown out of the handler, it would escape `ioc.run()` and terminate
+        code = INTERNAL_ERROR;
+        try {
+            std::rethrow_exception(e);
+        } catch (std::exception const& error) {
+            std::fprintf(stderr, "sast-evento-cli: %s\n", error.what());
+        } catch (...) {
+            std::fputs("sast-evento-cli: unknown error\n", stderr);
+        }
+    });
+    ioc.run();
+
+    if (code == USAGE_ERROR) {
+        std::fputs(USAGE, stderr);
+    }
+    if (options.profile) {
+        // the "network" and "cache" sections registered by `NetworkClient`
+        std::fputs(diagnostics()->dump().c_str(), stderr);
+    }
+    return code;
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <Controller/Core/UiWatchdog.h>
+#include <Infrastructure/Utils/Diagnostics.h>
+#include <Infrastructure/Utils/LatencyHistogram.h>
+#include <Infrastructure/Utils/Trace.h>
 #include <bitset>
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/co_spawn.hpp>
@@ -10,11 +14,16 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/system/detail/error_code.hpp>
 #include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <slint.h>
 #include <spdlog/spdlog.h>
 #include <thread>
 #include <tuple>
+#include <typeinfo>
 #include <utility>
 
 using namespace boost::asio::experimental::awaitable_operators;
@@ -49,15 +58,24 @@ public:
     */
     template<typename T, BOOST_ASIO_COMPLETION_TOKEN_FOR(void(T&)) CompletionCallback>
     void asyncExecute(Task<T> task, CompletionCallback&& callback) {
+        std::uint64_t traceId = 0;
+        auto spawned = measured(traceSpawn(std::move(task), traceId));
         net::co_spawn(_ioc,
-                      std::move(task),
-                      [callback = std::forward<CompletionCallback>(callback)](std::exception_ptr e,
-                                                                              T value) {
+                      std::move(spawned),
+                      [callback = std::forward<CompletionCallback>(callback),
+                       traceId,
+                       this](std::exception_ptr e, T value) {
+                          taskFinished(e);
                           if (!e) {
-                              slint::invoke_from_event_loop(
-                                  [callback = std::move(callback), value = std::move(value)]() {
-                                      callback(std::move(value));
-                                  });
+                              slint::invoke_from_event_loop([callback = std::move(callback),
+                                                             value = std::move(value),
+                                                             traceId]() {
+                                  TraceSpan span("executor", "callback");
+                                  tracer()->flow('f', "executor", "asyncExecute", traceId);
+                                  UiWatchdog::Scope scope("asyncExecute callback",
+                                                          typeid(CompletionCallback).name());
+                                  callback(std::move(value));
+                              });
                               return;
                           }
                           try {
@@ -81,11 +99,22 @@ public:
     */
     template<BOOST_ASIO_COMPLETION_TOKEN_FOR(void()) CompletionCallback>
     void asyncExecute(Task<void> task, CompletionCallback&& callback) {
+        std::uint64_t traceId = 0;
+        auto spawned = measured(traceSpawn(std::move(task), traceId));
         net::co_spawn(_ioc,
-                      std::move(task),
-                      [callback = std::forward<CompletionCallback>(callback)](std::exception_ptr e) {
+                      std::move(spawned),
+                      [callback = std::forward<CompletionCallback>(callback),
+                       traceId,
+                       this](std::exception_ptr e) {
+                          taskFinished(e);
                           if (!e) {
-                              slint::invoke_from_event_loop(callback);
+                              slint::invoke_from_event_loop([callback, traceId]() {
+                                  TraceSpan span("executor", "callback");
+                                  tracer()->flow('f', "executor", "asyncExecute", traceId);
+                                  UiWatchdog::Scope scope("asyncExecute callback",
+                                                          typeid(CompletionCallback).name());
+                                  callback();
+                              });
                               return;
                           }
                           try {
@@ -137,6 +166,31 @@ public:
 
     net::io_context& getIoContext() { return _ioc; }
 
+    // live gauges of the tasks started by `asyncExecute`, safe to read from any thread
+    struct Stats {
+        std::uint64_t inFlight;      // spawned and not finished yet
+        std::uint64_t finished;      // including failed
+        std::uint64_t failed;        // ended with an exception
+        std::uint64_t pendingTimers; // armed by `asyncExecuteByTimer` and not fired yet
+        // from being scheduled until running on the io thread, timers from their expiry
+        std::chrono::milliseconds delayP50;
+        std::chrono::milliseconds delayP95;
+        std::chrono::milliseconds delayP99;
+        std::chrono::milliseconds delayMax;
+    };
+
+    Stats stats() const {
+        std::lock_guard lock(_statsMutex);
+        return {.inFlight = _inFlight,
+                .finished = _finished,
+                .failed = _failed,
+                .pendingTimers = _pendingTimers,
+                .delayP50 = _schedulingDelay.percentile(0.5),
+                .delayP95 = _schedulingDelay.percentile(0.95),
+                .delayP99 = _schedulingDelay.percentile(0.99),
+                .delayMax = _schedulingDelay.max()};
+    }
+
     ~AsyncExecutor() {
         _ioc.stop();
         if (_iocThread.joinable()) {
@@ -146,17 +200,116 @@ public:
 
 private:
     AsyncExecutor() {
+        diagnostics()->add("executor", [this] {
+            auto stats = this->stats();
+            return std::format("  {} tasks in flight, {} finished, {} failed, "
+                               "{} timers pending\n"
+                               "  scheduling delay p50 {}ms p95 {}ms p99 {}ms max {}ms\n",
+                               stats.inFlight,
+                               stats.finished,
+                               stats.failed,
+                               stats.pendingTimers,
+                               stats.delayP50.count(),
+                               stats.delayP95.count(),
+                               stats.delayP99.count(),
+                               stats.delayMax.count());
+        });
         _iocThread = std::thread([this] {
+            tracer()->nameThread("io");
             net::signal_set signals{_ioc, SIGINT, SIGTERM};
             signals.async_wait([&](auto, auto) {
                 _ioc.stop();
                 slint::quit_event_loop();
             });
+#ifndef PLATFORM_WINDOWS
+            // `kill -USR1 <pid>` writes the diagnostics to the log
+            net::signal_set dumpSignals{_ioc, SIGUSR1};
+            std::function<void(boost::system::error_code, int)> onDump;
+            onDump = [&](boost::system::error_code ec, int) {
+                if (ec) {
+                    return;
+                }
+                spdlog::info("Diagnostics:\n{}", diagnostics()->dump());
+                dumpSignals.async_wait(onDump);
+            };
+            dumpSignals.async_wait(onDump);
+#endif
             net::executor_work_guard<decltype(_ioc.get_executor())> work{_ioc.get_executor()};
             _ioc.run();
         });
     }
 
+    // while tracing, wrap `task` into a span of its lifetime, linked by a flow from the caller
+    // through the io thread to the completion callback, `id` is set to the flow id or 0
+    template<typename T>
+    static Task<T> traceSpawn(Task<T> task, std::uint64_t& id) {
+        if (!tracer()->enabled()) {
+            id = 0;
+            return task;
+        }
+        id = tracer()->newId();
+        TraceSpan span("executor", "asyncExecute");
+        tracer()->flow('s', "executor", "asyncExecute", id);
+        return traced(std::move(task), id);
+    }
+
+    template<typename T>
+    static Task<T> traced(Task<T> task, std::uint64_t id) {
+        TraceAsyncSpan lifetime("executor", "task", id);
+        {
+            TraceSpan span("executor", "task start");
+            tracer()->flow('t', "executor", "asyncExecute", id);
+        }
+        co_return co_await std::move(task);
+    }
+
+    // count `task` as in flight and record how long it waits for the io thread
+    template<typename T>
+    Task<T> measured(Task<T> task) {
+        {
+            std::lock_guard lock(_statsMutex);
+            ++_inFlight;
+        }
+        return measuredFrom(std::move(task), this, std::chrono::steady_clock::now());
+    }
+
+    template<typename T>
+    static Task<T> measuredFrom(Task<T> task,
+                                AsyncExecutor* self,
+                                std::chrono::steady_clock::time_point scheduled) {
+        self->recordDelay(std::chrono::steady_clock::now() - scheduled);
+        co_return co_await std::move(task);
+    }
+
+    void recordDelay(std::chrono::steady_clock::duration delay) {
+        std::lock_guard lock(_statsMutex);
+        _schedulingDelay.record(std::chrono::duration_cast<std::chrono::microseconds>(delay));
+    }
+
+    void taskFinished(std::exception_ptr const& e) {
+        std::lock_guard lock(_statsMutex);
+        --_inFlight;
+        ++_finished;
+        if (e) {
+            ++_failed;
+        }
+    }
+
+    // a fired or cancelled timer, `expiry` is when it should have fired
+    void timerFired(net::steady_timer::time_point expiry, bool cancelled) {
+        std::lock_guard lock(_statsMutex);
+        --_pendingTimers;
+        if (!cancelled) {
+            _schedulingDelay.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                net::steady_timer::clock_type::now() - expiry));
+        }
+    }
+
+    void timerArmed() {
+        std::lock_guard lock(_statsMutex);
+        ++_pendingTimers;
+    }
+
     static AsyncExecutor* getInstance() {
         static AsyncExecutor s_instance;
         return &s_instance;
@@ -169,16 +322,21 @@ private:
                              std::chrono::steady_clock::duration interval,
                              int flag) {
         auto timer = std::make_shared<net::steady_timer>(_ioc, interval);
+        timerArmed();
         timer->async_wait([=,
                            func = std::forward<TaskFunc>(func),
                            callback = std::forward<CompletionCallback>(callback),
                            this](const boost::system::error_code& ec) {
+            timerFired(timer->expiry(), ec == net::error::operation_aborted);
             if (!ec) {
-                // ensure timer is captured
-                std::ignore = timer.get();
-                net::co_spawn(_ioc, func(), [callback](std::exception_ptr e) {
+                net::co_spawn(_ioc, measured(func()), [callback, this](std::exception_ptr e) {
+                    taskFinished(e);
                     if (!e) {
-                        slint::invoke_from_event_loop(callback);
+                        slint::invoke_from_event_loop([callback]() {
+                            UiWatchdog::Scope scope("asyncExecute callback",
+                                                    typeid(CompletionCallback).name());
+                            callback();
+                        });
                         return;
                     }
                     try {
@@ -203,27 +361,33 @@ private:
                              std::chrono::steady_clock::duration interval,
                              int flag) {
         auto timer = std::make_shared<net::steady_timer>(_ioc, interval);
+        timerArmed();
         timer->async_wait([=,
                            func = std::forward<TaskFunc>(func),
                            callback = std::forward<CompletionCallback>(callback),
                            this](const boost::system::error_code& ec) {
+            timerFired(timer->expiry(), ec == net::error::operation_aborted);
             if (!ec) {
-                // ensure timer is captured
-                std::ignore = timer.get();
-                net::co_spawn(_ioc, func(), [callback](std::exception_ptr e, auto value) {
-                    if (!e) {
-                        slint::invoke_from_event_loop(
-                            [callback = std::move(callback), value = std::move(value)]() {
-                                callback(std::move(value));
-                            });
-                        return;
-                    }
-                    try {
-                        std::rethrow_exception(e);
-                    } catch (std::exception& ex) {
-                        spdlog::error(ex.what());
-                    }
-                });
+                net::co_spawn(_ioc,
+                              measured(func()),
+                              [callback, this](std::exception_ptr e, auto value) {
+                                  taskFinished(e);
+                                  if (!e) {
+                                      slint::invoke_from_event_loop([callback = std::move(callback),
+                                                                     value = std::move(value)]() {
+                                          UiWatchdog::Scope scope(
+                                              "asyncExecute callback",
+                                              typeid(CompletionCallback).name());
+                                          callback(std::move(value));
+                                      });
+                                      return;
+                                  }
+                                  try {
+                                      std::rethrow_exception(e);
+                                  } catch (std::exception& ex) {
+                                      spdlog::error(ex.what());
+                                  }
+                              });
                 if (flag & TimerFlag::Periodic) {
                     asyncExecuteByTimer(std::move(func), std::move(callback), interval, flag);
                 }
@@ -237,6 +401,13 @@ private:
     net::io_context _ioc;
     std::thread _iocThread;
 
+    mutable std::mutex _statsMutex;
+    std::uint64_t _inFlight = 0;
+    std::uint64_t _finished = 0;
+    std::uint64_t _failed = 0;
+    std::uint64_t _pendingTimers = 0;
+    LatencyHistogram _schedulingDelay;
+
     friend AsyncExecutor* executor();
 };
 
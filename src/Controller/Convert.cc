@@ -1,6 +1,11 @@
+#include <Controller/AsyncExecutor.hh>
 #include <Controller/Convert.h>
+#include <Infrastructure/Cache/PixelCache.h>
 #include <Infrastructure/Utils/Tools.h>
+#include <Infrastructure/Utils/Trace.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/asio/post.hpp>
+#include <cstring>
 #include <ranges>
 #include <spdlog/spdlog.h>
 
@@ -99,6 +104,7 @@ EventStruct from(const EventEntity& entity) {
 }
 
 std::shared_ptr<slint::VectorModel<EventStruct>> from(const std::vector<EventEntity>& list) {
+    TraceSpan span("convert", "events");
     auto transformedList = list | std::views::transform([&](const EventEntity& entity) {
                                auto startTime = parseIso8601Utc(entity.start.c_str());
                                auto startDuration = std::chrono::system_clock::from_time_t(startTime)
@@ -119,8 +125,43 @@ std::shared_ptr<slint::VectorModel<EventStruct>> from(const std::vector<EventEnt
     return std::make_shared<slint::VectorModel<EventStruct>>(model);
 }
 
+slint::Image from(const std::filesystem::path& image) {
+    TraceSpan span("convert", "image", tracer()->enabled() ? image.filename().string() : "");
+    if (auto pixels = pixelCache()->load(image)) {
+        if (pixels->stride() == pixels->width() * sizeof(slint::Rgba8Pixel)) {
+            return slint::Image(slint::SharedPixelBuffer<slint::Rgba8Pixel>(
+                pixels->width(),
+                pixels->height(),
+                reinterpret_cast<const slint::Rgba8Pixel*>(pixels->data())));
+        }
+        slint::SharedPixelBuffer<slint::Rgba8Pixel> buffer(pixels->width(), pixels->height());
+        auto rowSize = pixels->width() * sizeof(slint::Rgba8Pixel);
+        for (std::uint32_t row = 0; row < pixels->height(); ++row) {
+            std::memcpy(reinterpret_cast<std::uint8_t*>(buffer.begin()) + row * rowSize,
+                        pixels->data() + static_cast<std::size_t>(row) * pixels->stride(),
+                        rowSize);
+        }
+        return slint::Image(buffer);
+    }
+
+    auto decoded = slint::Image::load_from_path(slint::SharedString(image.u8string()));
+    // vector images can not be rasterized ahead of time, only cache bitmaps
+    if (auto buffer = decoded.to_rgba8()) {
+        // written in the io thread, mostly called from the UI thread; the buffer is shared,
+        // not copied, and only read there
+        net::post(executor()->getIoContext(), [image, pixels = std::move(*buffer)] {
+            pixelCache()->store(image,
+                                pixels.width(),
+                                pixels.height(),
+                                pixels.width() * sizeof(slint::Rgba8Pixel),
+                                reinterpret_cast<const std::uint8_t*>(pixels.begin()));
+        });
+    }
+    return decoded;
+}
+
 ContributorStruct from(const std::filesystem::path& avatar, const std::string& htmlUrl) {
-    return {.avatar = slint::Image::load_from_path(slint::SharedString(avatar.u8string())),
+    return {.avatar = from(avatar),
             .html_url = slint::SharedString(htmlUrl)};
 }
 
@@ -21,6 +21,9 @@ EventStruct from(const EventEntity& entity);
 
 std::shared_ptr<slint::VectorModel<EventStruct>> from(const std::vector<EventEntity>& list);
 
+// decode an image file, reusing the pre-decoded pixels of `PixelCache` when available
+slint::Image from(const std::filesystem::path& image);
+
 ContributorStruct from(const std::filesystem::path& avatar, const std::string& htmlUrl);
 
 FeedbackStruct from(const std::optional<FeedbackEntity>& entity);
@@ -304,6 +304,8 @@ void AccountManager::setLoginState(bool newState) {
 }
 
 void AccountManager::onStateChanged() {
+    // the change feed tells the subscriptions of the token it was opened with
+    evento::executor()->asyncExecute(evento::networkClient()->reconnectChanges(), [] {});
     if (isLogin()) {
         UiUtility::StylishLog::viewActionTriggered(logOrigin, "onLogin");
         bridge.call(bridge.actions.onLogin);
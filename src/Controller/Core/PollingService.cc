@@ -0,0 +1,292 @@
+#include <Controller/Core/PollingService.h>
+#include <Infrastructure/Network/NetworkClient.h>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <spdlog/spdlog.h>
+
+EVENTO_UI_START
+
+struct PollingService::Entry {
+    std::string name;
+    Poller poller;
+    Cadence cadence;
+    slint::Timer timer;
+    bool inFlight = false;
+    std::uint64_t generation = 0; // of the poll in flight
+    bool stopped = false;
+    int unchanged = 0; // responses in a row
+    std::chrono::seconds current{};
+    Clock::time_point started;
+    Clock::time_point lastPoll;
+    std::uint64_t polls = 0;
+    std::uint64_t changes = 0;
+    std::uint64_t bytes = 0;
+};
+
+namespace {
+
+double perHour(std::uint64_t count, PollingService::Clock::time_point since) {
+    auto hours = std::chrono::duration<double, std::ratio<3600>>(PollingService::Clock::now()
+                                                                 - since)
+                     .count();
+    return hours > 0 ? static_cast<double>(count) / hours : 0;
+}
+
+} // namespace
+
+PollingService::PollingService()
+    : _lastActivity(Clock::now())
+    , _started(Clock::now()) {}
+
+PollingService::~PollingService() {
+    stopAll();
+}
+
+void PollingService::start(std::string const& name, Poller poller, Cadence cadence) {
+    stop(name);
+    auto entry = std::make_shared<Entry>();
+    entry->name = name;
+    entry->poller = std::move(poller);
+    entry->cadence = cadence;
+    entry->started = Clock::now();
+    entry->lastPoll = entry->started;
+    _entries[name] = entry;
+    arm(entry);
+}
+
+void PollingService::stop(std::string const& name) {
+    auto it = _entries.find(name);
+    if (it == _entries.end()) {
+        return;
+    }
+    // a poll in flight finds it stopped when done
+    it->second->stopped = true;
+    it->second->timer.stop();
+    _entries.erase(it);
+    updateSnapshot();
+}
+
+void PollingService::stopAll() {
+    for (auto& [name, entry] : _entries) {
+        entry->stopped = true;
+        entry->timer.stop();
+    }
+    _entries.clear();
+    updateSnapshot();
+}
+
+void PollingService::setVisible(bool visible) {
+    if (_visible == visible) {
+        return;
+    }
+    _visible = visible;
+    for (auto& [name, pausable] : _pausables) {
+        visible ? pausable.resume() : pausable.pause();
+    }
+    if (visible) {
+        // pollers overdue for the visible cadence run right away
+        touch();
+    }
+    rearmAll();
+    updateSnapshot();
+}
+
+void PollingService::touch() {
+    auto wasIdle = idle();
+    _lastActivity = Clock::now();
+    if (wasIdle) {
+        rearmAll();
+    }
+}
+
+void PollingService::setPushed(bool pushed) {
+    if (_pushed == pushed) {
+        return;
+    }
+    _pushed = pushed;
+    rearmAll();
+}
+
+void PollingService::pollNow(std::string const& name) {
+    auto it = _entries.find(name);
+    if (it == _entries.end() || it->second->inFlight) {
+        return;
+    }
+    it->second->timer.stop();
+    poll(it->second);
+}
+
+void PollingService::setBoundaries(std::vector<std::chrono::system_clock::time_point> boundaries) {
+    std::sort(boundaries.begin(), boundaries.end());
+    if (boundaries == _boundaries) {
+        return;
+    }
+    _boundaries = std::move(boundaries);
+    rearmAll();
+}
+
+void PollingService::addPausable(std::string name,
+                                 std::function<void()> pause,
+                                 std::function<void()> resume) {
+    _pausables[std::move(name)] = {std::move(pause), std::move(resume)};
+}
+
+void PollingService::countWakeup(std::string const& name) {
+    std::lock_guard lock(_snapshotMutex);
+    ++_snapshot.uiWakeups[name];
+}
+
+std::chrono::seconds PollingService::intervalOf(std::string const& name) const {
+    auto it = _entries.find(name);
+    return it == _entries.end() ? std::chrono::seconds{} : it->second->current;
+}
+
+void PollingService::arm(std::shared_ptr<Entry> const& entry) {
+    entry->current = interval(*entry);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now()
+                                                                         - entry->lastPoll);
+    auto remaining = std::max(std::chrono::milliseconds(1),
+                              std::chrono::milliseconds(entry->current) - elapsed);
+    entry->timer.start(slint::TimerMode::SingleShot,
+                       remaining,
+                       [this, weak = std::weak_ptr(entry)] {
+                           if (auto entry = weak.lock(); entry && !entry->stopped) {
+                               poll(entry);
+                           }
+                       });
+    updateSnapshot();
+}
+
+void PollingService::poll(std::shared_ptr<Entry> const& entry) {
+    entry->inFlight = true;
+    auto generation = ++entry->generation;
+    entry->lastPoll = Clock::now();
+    ++entry->polls;
+    auto bytesBefore = networkClient()->metrics().totalBodyBytes();
+    // the timer is idle while a poll is in flight, it watches over the poll meanwhile
+    entry->timer.start(slint::TimerMode::SingleShot,
+                       POLL_TIMEOUT,
+                       [this, weak = std::weak_ptr(entry), generation] {
+                           auto entry = weak.lock();
+                           if (!entry || entry->stopped || entry->generation != generation) {
+                               return;
+                           }
+                           spdlog::warn("Poll of {} was not handled in time", entry->name);
+                           ++entry->generation;
+                           entry->inFlight = false;
+                           ++entry->unchanged;
+                           arm(entry);
+                       });
+    entry->poller([this, weak = std::weak_ptr(entry), bytesBefore, generation](bool changed) {
+        auto entry = weak.lock();
+        if (!entry || entry->stopped || !entry->inFlight || entry->generation != generation) {
+            return;
+        }
+        entry->inFlight = false;
+        // approximate, requests running meanwhile count as well, zero across a metrics reset
+        auto bytesAfter = networkClient()->metrics().totalBodyBytes();
+        entry->bytes += bytesAfter > bytesBefore ? bytesAfter - bytesBefore : 0;
+        if (changed) {
+            entry->unchanged = 0;
+            ++entry->changes;
+        } else {
+            ++entry->unchanged;
+        }
+        arm(entry);
+    });
+}
+
+std::chrono::seconds PollingService::interval(Entry const& entry) const {
+    using std::chrono::seconds;
+    auto const& cadence = entry.cadence;
+    auto backoff = std::min(std::pow(1.5, entry.unchanged), cadence.maxBackoff);
+    auto result = seconds(static_cast<seconds::rep>(static_cast<double>(cadence.base.count())
+                                                    * backoff));
+    if (idle()) {
+        result = std::max(result, cadence.idle);
+    }
+    if (!_visible) {
+        result = std::max(result, cadence.hidden);
+    }
+    if (_pushed) {
+        // boundaries are pushed as the state changes as well
+        return std::max(result, cadence.pushed);
+    }
+    if (nearBoundary()) {
+        return std::min(result, _visible ? cadence.nearBoundary : cadence.hiddenNearBoundary);
+    }
+
+    // wake up when the next boundary comes near, however slow the cadence is
+    auto now = std::chrono::system_clock::now();
+    auto next = std::upper_bound(_boundaries.begin(), _boundaries.end(), now);
+    if (next != _boundaries.end()) {
+        auto untilNear = std::chrono::duration_cast<seconds>(*next - BOUNDARY_WINDOW - now);
+        result = std::clamp(untilNear, seconds(1), result);
+    }
+    return result;
+}
+
+bool PollingService::nearBoundary() const {
+    auto now = std::chrono::system_clock::now();
+    return std::any_of(_boundaries.begin(), _boundaries.end(), [now](auto boundary) {
+        return boundary > now - BOUNDARY_WINDOW && boundary < now + BOUNDARY_WINDOW;
+    });
+}
+
+bool PollingService::idle() const {
+    return Clock::now() - _lastActivity > IDLE_AFTER;
+}
+
+void PollingService::rearmAll() {
+    for (auto& [name, entry] : _entries) {
+        if (!entry->inFlight) {
+            arm(entry);
+        }
+    }
+}
+
+void PollingService::updateSnapshot() {
+    std::vector<Row> pollers;
+    for (auto const& [name, entry] : _entries) {
+        pollers.push_back({.name = name,
+                           .interval = entry->current,
+                           .polls = entry->polls,
+                           .changes = entry->changes,
+                           .bytes = entry->bytes,
+                           .started = entry->started});
+    }
+    std::lock_guard lock(_snapshotMutex);
+    _snapshot.visible = _visible;
+    _snapshot.pushed = _pushed;
+    _snapshot.idle = idle();
+    _snapshot.nearBoundary = nearBoundary();
+    _snapshot.pollers = std::move(pollers);
+}
+
+std::string PollingService::dump() const {
+    std::lock_guard lock(_snapshotMutex);
+    auto result = std::format("  window {}, user {}, changes {}{}\n",
+                              _snapshot.visible ? "visible" : "hidden",
+                              _snapshot.idle ? "idle" : "active",
+                              _snapshot.pushed ? "pushed" : "polled",
+                              _snapshot.nearBoundary ? ", near an event boundary" : "");
+    for (auto const& row : _snapshot.pollers) {
+        result += std::format("  {}: every {}s, {} polls, {} changed, "
+                              "{:.1f} wakeups/h, {:.1f} KiB/h\n",
+                              row.name,
+                              row.interval.count(),
+                              row.polls,
+                              row.changes,
+                              perHour(row.polls, row.started),
+                              perHour(row.bytes, row.started) / 1024);
+    }
+    for (auto const& [name, wakeups] : _snapshot.uiWakeups) {
+        result += std::format("  ui timer {}: {:.1f} wakeups/h\n",
+                              name,
+                              perHour(wakeups, _started));
+    }
+    return result;
+}
+
+EVENTO_UI_END
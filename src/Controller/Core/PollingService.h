@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Controller/Core/UiBase.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EVENTO_UI_START
+
+// Runs background refreshes at a cadence that follows what the user can notice:
+// - fast around the start or end of a subscribed event, see `setBoundaries()`
+// - slower after each response that changed nothing, back to the base on a change
+// - slow while the user is idle, i.e. no navigation for `IDLE_AFTER`
+// - slowest while the window is hidden, UI timers registered as pausable stop meanwhile
+// - a safety net only while the backend pushes changes, see `setPushed()`
+//
+// Each poller gets a single-shot timer re-armed after its poll is handled, so polls never
+// overlap. A poll not handled within `POLL_TIMEOUT`, e.g. its task threw and its callback
+// was dropped, counts as unchanged and a late `done` is ignored. Wakeups and bytes received
+// are counted for the "polling" diagnostics section.
+// All members but `dump()` must be called in the UI thread.
+class PollingService {
+public:
+    using Clock = std::chrono::steady_clock;
+    // starts a refresh, calls `done` in the UI thread once it is handled,
+    // with whether the data changed
+    using Poller = std::function<void(std::function<void(bool changed)> done)>;
+
+    struct Cadence {
+        std::chrono::seconds base{60};
+        std::chrono::seconds nearBoundary{20};  // visible
+        std::chrono::seconds hiddenNearBoundary{120};
+        std::chrono::seconds idle{300};
+        std::chrono::seconds hidden{900};
+        std::chrono::seconds pushed{1800};
+        // unchanged responses stretch `base` up to this factor
+        double maxBackoff = 4;
+    };
+
+    static constexpr std::chrono::minutes BOUNDARY_WINDOW{15};
+    static constexpr std::chrono::minutes IDLE_AFTER{5};
+    static constexpr std::chrono::minutes POLL_TIMEOUT{2};
+
+    PollingService();
+    PollingService(const PollingService&) = delete;
+    PollingService& operator=(const PollingService&) = delete;
+    ~PollingService();
+
+    // replaces a poller of the same name, the first poll is after one interval
+    void start(std::string const& name, Poller poller, Cadence cadence = {});
+    void stop(std::string const& name);
+    void stopAll();
+
+    // window shown or hidden, hidden windows get no UI timer ticks
+    void setVisible(bool visible);
+    [[nodiscard]] bool visible() const { return _visible; }
+    // user activity, e.g. navigation
+    void touch();
+    // changes arrive over the change feed of `NetworkClient`
+    void setPushed(bool pushed);
+    // poll now, e.g. to catch up after a push reconnected, no-op while a poll is in flight
+    void pollNow(std::string const& name);
+    // start and end times of the events the user cares about
+    void setBoundaries(std::vector<std::chrono::system_clock::time_point> boundaries);
+
+    // `resume` runs when the window is shown again, `pause` when it is hidden
+    void addPausable(std::string name, std::function<void()> pause, std::function<void()> resume);
+    // a tick of a UI timer, for the wakeup count
+    void countWakeup(std::string const& name);
+
+    [[nodiscard]] std::chrono::seconds intervalOf(std::string const& name) const;
+    // for the diagnostics dump, thread-safe
+    [[nodiscard]] std::string dump() const;
+
+private:
+    struct Entry;
+
+    void arm(std::shared_ptr<Entry> const& entry);
+    void poll(std::shared_ptr<Entry> const& entry);
+    [[nodiscard]] std::chrono::seconds interval(Entry const& entry) const;
+    [[nodiscard]] bool nearBoundary() const;
+    [[nodiscard]] bool idle() const;
+    // re-arm every poller for a cadence change, polls in flight re-arm when done
+    void rearmAll();
+
+    struct Pausable {
+        std::function<void()> pause;
+        std::function<void()> resume;
+    };
+
+    // what `dump()` shows, it may be called from any thread
+    struct Row {
+        std::string name;
+        std::chrono::seconds interval;
+        std::uint64_t polls;
+        std::uint64_t changes;
+        std::uint64_t bytes;
+        Clock::time_point started;
+    };
+    struct Snapshot {
+        bool visible = true;
+        bool pushed = false;
+        bool idle = false;
+        bool nearBoundary = false;
+        std::vector<Row> pollers;
+        std::map<std::string, std::uint64_t> uiWakeups;
+    };
+    void updateSnapshot();
+
+    std::map<std::string, std::shared_ptr<Entry>> _entries;
+    std::map<std::string, Pausable> _pausables;
+    std::vector<std::chrono::system_clock::time_point> _boundaries;
+    bool _visible = true;
+    bool _pushed = false;
+    Clock::time_point _lastActivity;
+    Clock::time_point _started;
+
+    mutable std::mutex _snapshotMutex;
+    Snapshot _snapshot;
+};
+
+EVENTO_UI_END
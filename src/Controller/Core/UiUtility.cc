@@ -4,9 +4,10 @@
 
 EVENTO_UI_START
 
-std::string UiUtility::getViewName(ViewName target) {
-    return viewNameMapper.find(target) == viewNameMapper.end() ? "[Unknown View]"
-                                                               : viewNameMapper.at(target);
+std::string const& UiUtility::getViewName(ViewName target) {
+    static const std::string unknown = "[Unknown View]";
+    auto it = viewNameMapper.find(target);
+    return it == viewNameMapper.end() ? unknown : it->second;
 }
 
 bool UiUtility::isTransparent(ViewName target) {
@@ -7,7 +7,7 @@ EVENTO_UI_START
 
 class UiUtility {
 public:
-    static std::string getViewName(ViewName target);
+    static std::string const& getViewName(ViewName target);
     static bool isTransparent(ViewName target);
 
     class StylishLog {
@@ -0,0 +1,104 @@
+#include <Controller/Core/UiWatchdog.h>
+#include <boost/core/demangle.hpp>
+#include <format>
+#include <spdlog/spdlog.h>
+
+EVENTO_UI_START
+
+UiWatchdog::~UiWatchdog() {
+    stop();
+}
+
+void UiWatchdog::start() {
+    std::lock_guard lock(_mutex);
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _thread = std::thread([this] { run(); });
+}
+
+void UiWatchdog::stop() {
+    {
+        std::lock_guard lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _running = false;
+    }
+    _cv.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void UiWatchdog::run() {
+    std::unique_lock lock(_mutex);
+    while (_running) {
+        auto sequence = ++_lastPing;
+        auto sent = std::chrono::steady_clock::now();
+        lock.unlock();
+        slint::invoke_from_event_loop([this, sequence, sent] { onPong(sequence, sent); });
+        lock.lock();
+
+        auto answered = [&] { return _lastPong >= sequence || !_running; };
+        if (!_cv.wait_for(lock, STALL_THRESHOLD, answered)) {
+            // whatever runs now is what holds the loop
+            auto scope = currentScope();
+            _cv.wait(lock, answered);
+            if (!_running) {
+                break;
+            }
+            auto stall = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - sent);
+            ++_stalls;
+            if (stall > _worstStall) {
+                _worstStall = stall;
+                _worstStallScope = scope;
+            }
+            spdlog::warn("UI thread stalled for {}ms in {}", stall.count(), scope);
+        }
+
+        _cv.wait_for(lock, PING_INTERVAL, [this] { return !_running; });
+    }
+}
+
+void UiWatchdog::onPong(std::uint64_t sequence, std::chrono::steady_clock::time_point sent) {
+    {
+        std::lock_guard lock(_mutex);
+        _dispatchDelay.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - sent));
+        _lastPong = sequence;
+    }
+    _cv.notify_all();
+}
+
+std::string UiWatchdog::currentScope() {
+    auto tag = s_tag.load(std::memory_order_relaxed);
+    auto detail = s_detail.load(std::memory_order_relaxed);
+    if (!tag) {
+        return "[Unknown Scope]";
+    }
+    if (!detail) {
+        return tag;
+    }
+    // callbacks are tagged with their type name, which tells the function they come from
+    return std::format("{} ({})", tag, boost::core::demangle(detail));
+}
+
+std::string UiWatchdog::dump() const {
+    std::lock_guard lock(_mutex);
+    return std::format("  dispatch delay p50 {}ms p95 {}ms p99 {}ms max {}ms over {} pings\n"
+                       "  {} stalls over {}ms, worst {}ms in {}\n",
+                       _dispatchDelay.percentile(0.5).count(),
+                       _dispatchDelay.percentile(0.95).count(),
+                       _dispatchDelay.percentile(0.99).count(),
+                       _dispatchDelay.max().count(),
+                       _dispatchDelay.count(),
+                       _stalls,
+                       STALL_THRESHOLD.count(),
+                       _worstStall.count(),
+                       _worstStallScope.empty() ? "-" : _worstStallScope);
+}
+
+EVENTO_UI_END
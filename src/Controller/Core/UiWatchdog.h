@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Controller/Core/UiBase.h>
+#include <Infrastructure/Utils/LatencyHistogram.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+EVENTO_UI_START
+
+// Pings the Slint event loop from a thread of its own and measures how long each ping waits
+// to be dispatched. A ping stuck for longer than `STALL_THRESHOLD` is reported as a stall,
+// along with the innermost `Scope` the UI thread was in when the stall was detected.
+class UiWatchdog {
+public:
+    // tags what the UI thread is running, scopes nest,
+    // `tag` and `detail` must be string literals or otherwise live as long as the program
+    class Scope {
+    public:
+        Scope(const char* tag, const char* detail = nullptr)
+            : _previousTag(s_tag.exchange(tag, std::memory_order_relaxed))
+            , _previousDetail(s_detail.exchange(detail, std::memory_order_relaxed)) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() {
+            s_tag.store(_previousTag, std::memory_order_relaxed);
+            s_detail.store(_previousDetail, std::memory_order_relaxed);
+        }
+
+    private:
+        const char* _previousTag;
+        const char* _previousDetail;
+    };
+
+    UiWatchdog() = default;
+    UiWatchdog(const UiWatchdog&) = delete;
+    UiWatchdog& operator=(const UiWatchdog&) = delete;
+    ~UiWatchdog();
+
+    // must be called with the event loop running or about to run
+    void start();
+    void stop();
+
+    // dispatch delay histogram and stalls, for the diagnostics dump
+    [[nodiscard]] std::string dump() const;
+
+    static constexpr std::chrono::milliseconds PING_INTERVAL{200};
+    static constexpr std::chrono::milliseconds STALL_THRESHOLD{50};
+
+private:
+    void run();
+    // in the UI thread
+    void onPong(std::uint64_t sequence, std::chrono::steady_clock::time_point sent);
+    static std::string currentScope();
+
+    static inline std::atomic<const char*> s_tag = nullptr;
+    static inline std::atomic<const char*> s_detail = nullptr;
+
+    std::thread _thread;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _running = false;
+    std::uint64_t _lastPing = 0;
+    std::uint64_t _lastPong = 0;
+    LatencyHistogram _dispatchDelay;
+    std::uint64_t _stalls = 0;
+    std::chrono::milliseconds _worstStall{0};
+    std::string _worstStallScope;
+};
+
+EVENTO_UI_END
@@ -1,6 +1,10 @@
+#include <Controller/AsyncExecutor.hh>
 #include <Controller/Core/UiUtility.h>
+#include <Controller/Core/UiWatchdog.h>
 #include <Controller/Core/ViewManager.h>
 #include <Controller/UiBridge.h>
+#include <Infrastructure/Network/NetworkClient.h>
+#include <Infrastructure/Utils/Trace.h>
 #include <algorithm>
 #include <cassert>
 #include <set>
@@ -17,6 +21,7 @@ ViewManager::ViewManager(slint::ComponentHandle<UiEntryName> uiEntry, UiBridge&
     self->on_clean_navigate_to([this](ViewName newView) { cleanNavigateTo(newView); });
     self->on_replace_navigate_to([this](ViewName newView) { replaceNavigateTo(newView); });
     self->on_prior_view([this]() { priorView(); });
+    self->on_navigate_intent([this](ViewName target) { navigateIntent(target); });
 
     self->on_is_show([&self](ViewName target) {
         // used to trigger re-calculate
@@ -39,7 +44,10 @@ void ViewManager::initStack(ViewName newView, std::any data) {
 
 void ViewManager::navigateTo(ViewName newView, std::any data) {
     auto& self = *this;
+    TraceSpan span("ui", "navigateTo", UiUtility::getViewName(newView));
+    UiWatchdog::Scope scope("navigateTo", UiUtility::getViewName(newView).c_str());
     navAssert();
+    bridge.getPollingService().touch();
     if (newView == viewStack.top()) {
         return;
     }
@@ -51,7 +59,10 @@ void ViewManager::navigateTo(ViewName newView, std::any data) {
 
 void ViewManager::cleanNavigateTo(ViewName newView, std::any data) {
     auto& self = *this;
+    TraceSpan span("ui", "cleanNavigateTo", UiUtility::getViewName(newView));
+    UiWatchdog::Scope scope("cleanNavigateTo", UiUtility::getViewName(newView).c_str());
     navAssert();
+    bridge.getPollingService().touch();
     if (newView == viewStack.top()) {
         return;
     }
@@ -70,7 +81,10 @@ void ViewManager::cleanNavigateTo(ViewName newView, std::any data) {
 
 void ViewManager::replaceNavigateTo(ViewName newView, std::any data) {
     auto& self = *this;
+    TraceSpan span("ui", "replaceNavigateTo", UiUtility::getViewName(newView));
+    UiWatchdog::Scope scope("replaceNavigateTo", UiUtility::getViewName(newView).c_str());
     navAssert();
+    bridge.getPollingService().touch();
 
     popView();
     if (newView == viewStack.top()) {
@@ -83,7 +97,10 @@ void ViewManager::replaceNavigateTo(ViewName newView, std::any data) {
 
 void ViewManager::priorView() {
     auto& self = *this;
+    TraceSpan span("ui", "priorView");
+    UiWatchdog::Scope scope("priorView");
     navAssert();
+    bridge.getPollingService().touch();
 
     if (viewStack.size() <= 1) {
         spdlog::debug("ViewManager: pop action canceled: only one view left");
@@ -99,6 +116,19 @@ bool ViewManager::isVisible(ViewName target) {
     return visibleViews.find(target) != visibleViews.end();
 }
 
+void ViewManager::navigateIntent(ViewName target) {
+    // hovering counts as activity, idle pollers speed up before the click
+    bridge.getPollingService().touch();
+    if (!viewStack.empty() && target == viewStack.top()) {
+        return;
+    }
+    executor()->asyncExecute(networkClient()->warmUpEvento(), [] {});
+    if (target == ViewName::AboutPage) {
+        // contributors and releases
+        executor()->asyncExecute(networkClient()->warmUpGithub(), [] {});
+    }
+}
+
 void ViewManager::pushView(ViewName newView, std::any&& data) {
     viewStack.push(newView);
     viewData.emplace(std::move(data));
@@ -145,6 +175,7 @@ void ViewManager::syncViewVisibility() {
 
 void ViewManager::showView(ViewName target) {
     auto& self = *this;
+    TraceSpan span("ui", "onShow", UiUtility::getViewName(target));
 
     UiUtility::StylishLog::viewVisibilityChanged(logOrigin, "show", UiUtility::getViewName(target));
     visibleViews.emplace(target);
@@ -154,6 +185,7 @@ void ViewManager::showView(ViewName target) {
 
 void ViewManager::hideView(ViewName target) {
     auto& self = *this;
+    TraceSpan span("ui", "onHide", UiUtility::getViewName(target));
 
     UiUtility::StylishLog::viewActionTriggered(logOrigin, "onHide", UiUtility::getViewName(target));
     bridge.call(bridge.actions.onHide, target);
@@ -53,6 +53,9 @@ public:
     // check view visibility
     bool isVisible(ViewName target);
 
+    // the user is about to navigate to `target`, warm up the connections it is going to use
+    void navigateIntent(ViewName target);
+
     /**
     * get data corresponding to current view, set by all navigate function,
     * useful when needed to transfer data between view or save data for current view in case of a view opened twice,
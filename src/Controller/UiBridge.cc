@@ -1,3 +1,4 @@
+#include <Controller/AsyncExecutor.hh>
 #include <Controller/Core/AccountManager.h>
 #include <Controller/Core/MessageManager.h>
 #include <Controller/Core/UiUtility.h>
@@ -12,7 +13,12 @@
 #include <Controller/View/MyEventPage.h>
 #include <Controller/View/SearchPage.h>
 #include <Controller/View/SettingPage.h>
+#include <Infrastructure/IPC/SocketClient.h>
+#include <Infrastructure/Network/NetworkClient.h>
 #include <Infrastructure/Utils/Config.h>
+#include <Infrastructure/Utils/Diagnostics.h>
+#include <Infrastructure/Utils/StartupTimeline.h>
+#include <Infrastructure/Utils/Trace.h>
 #include <memory>
 #include <spdlog/spdlog.h>
 
@@ -31,8 +37,11 @@ UiBridge::UiBridge(slint::ComponentHandle<UiEntryName> uiEntry)
 
     // take control of exit event loop from slint, make minimalToTray effective immediately, work with slint::EventLoopMode::RunUntilQuit
     uiEntry->window().on_close_requested([this] {
-        if (!settings.minimalToTray) {
+        // without a tray there is no way back to a hidden window
+        if (!settings.minimalToTray || !ipc() || !ipc()->trayConnected()) {
             exit();
+        } else {
+            pollingService.setVisible(false);
         }
         return slint::CloseRequestResponse::HideWindow;
     });
@@ -42,6 +51,12 @@ UiBridge::UiBridge(slint::ComponentHandle<UiEntryName> uiEntry)
     if (!accountManager->isLogin()) {
         viewManager->initStack(ViewName::LoginOverlay);
     }
+
+    // benchmark run, see `bench/startup.py`
+    if (startupTimeline()->reporting()) {
+        startupTimeline()->onComplete(
+            [this] { slint::invoke_from_event_loop([this] { exit(); }); });
+    }
 }
 
 void UiBridge::attachView(ViewName name, std::shared_ptr<BasicView> object) {
@@ -60,19 +75,41 @@ MessageManager& UiBridge::getMessageManager() {
     return *messageManager;
 }
 
+PollingService& UiBridge::getPollingService() {
+    return pollingService;
+}
+
 slint::ComponentHandle<UiEntryName> UiBridge::getUiEntry() {
     return uiEntry;
 }
 
 void UiBridge::show() {
     uiEntry->show();
+    pollingService.setVisible(true);
 }
 
 void UiBridge::run() {
     UiUtility::StylishLog::viewActionTriggered(logOrigin, "onCreate");
-    call(actions::onCreate);
+    {
+        TraceSpan span("ui", "onCreate");
+        call(actions::onCreate);
+    }
+    startupTimeline()->mark("onCreate");
 
+    // not every renderer supports the notifier, then the frame is assumed
+    // to be drawn right after the show
+    auto notified = uiEntry->window().set_rendering_notifier(
+        [this, drawn = false](slint::RenderingState state, slint::GraphicsAPI) mutable {
+            if (!drawn && state == slint::RenderingState::AfterRendering) {
+                drawn = true;
+                onFirstFrame();
+            }
+        });
     show();
+    startupTimeline()->mark("show");
+    if (!notified) {
+        slint::invoke_from_event_loop([this] { onFirstFrame(); });
+    }
     spdlog::debug("--- enter slint event loop ---");
     eventLoopRunning = true;
 
@@ -89,6 +126,7 @@ void UiBridge::run() {
 
 void UiBridge::hide() {
     uiEntry->hide();
+    pollingService.setVisible(false);
 }
 
 void UiBridge::exit() {
@@ -107,15 +145,39 @@ void UiBridge::call(Action& action) {
     std::for_each(views.begin(),
                   views.end(),
                   [&action](const std::pair<const ViewName, std::shared_ptr<BasicView>>& view) {
+                      UiWatchdog::Scope scope(actionName(action),
+                                              UiUtility::getViewName(view.first).c_str());
                       action(*view.second);
                   });
 }
 
 void UiBridge::call(Action& action, ViewName target) {
     slint::private_api::assert_main_thread();
+    UiWatchdog::Scope scope(actionName(action), UiUtility::getViewName(target).c_str());
     action(*views.at(target));
 }
 
+const char* UiBridge::actionName(Action const& action) {
+    if (&action == &actions::onCreate) {
+        return "onCreate";
+    } else if (&action == &actions::onStart) {
+        return "onStart";
+    } else if (&action == &actions::onLogin) {
+        return "onLogin";
+    } else if (&action == &actions::onShow) {
+        return "onShow";
+    } else if (&action == &actions::onHide) {
+        return "onHide";
+    } else if (&action == &actions::onLogout) {
+        return "onLogout";
+    } else if (&action == &actions::onStop) {
+        return "onStop";
+    } else if (&action == &actions::onDestroy) {
+        return "onDestroy";
+    }
+    return "action";
+}
+
 void UiBridge::attachAllViews() {
     attachView(ViewName::DiscoveryPage, std::make_shared<DiscoveryPage>(uiEntry, *this));
     attachView(ViewName::SearchPage, std::make_shared<SearchPage>(uiEntry, *this));
@@ -132,18 +194,94 @@ void UiBridge::onEnterEventLoop() {
     auto& self = *this;
 
     UiUtility::StylishLog::viewActionTriggered(logOrigin, "onStart");
+    TraceSpan span("ui", "onStart");
     self.call(actions::onStart);
 
     viewManager->onEnterEventLoop();
+    startupTimeline()->mark("onStart");
+
+    watchdog.start();
+    diagnostics()->add("ui", [this] { return watchdog.dump(); });
+    diagnostics()->add("polling", [this] { return pollingService.dump(); });
+
+    auto listener = [this](bool online) {
+        slint::invoke_from_event_loop([this, online] { onConnectivityChanged(online); });
+    };
+    executor()->asyncExecute(networkClient()->watchConnectivity(std::move(listener)), [] {});
+
+    // changes arrive as they happen while the backend pushes them, polled otherwise
+    ChangeListener changes{.state =
+                               [this](PushState state) {
+                                   slint::invoke_from_event_loop(
+                                       [this, state] { onPushStateChanged(state); });
+                               },
+                           .change =
+                               [this](EventChange const&) {
+                                   slint::invoke_from_event_loop([this] { onEventPushed(); });
+                               }};
+    executor()->asyncExecute(networkClient()->watchChanges(std::move(changes)), [] {});
+}
+
+void UiBridge::onFirstFrame() {
+    startupTimeline()->mark(StartupTimeline::FIRST_FRAME);
+
+    // spawned in the io thread, notifications start it on demand as well
+    if (settings.minimalToTray && ipc()) {
+        ipc()->startTray();
+    }
+}
+
+void UiBridge::onPushStateChanged(PushState state) {
+    pollingService.setPushed(state == PushState::Connected);
+    if (state == PushState::Connected) {
+        // what changed while the feed was down
+        pollingService.pollNow("subscribed events");
+    }
+}
+
+void UiBridge::onEventPushed() {
+    pushedReload.start(slint::TimerMode::SingleShot, std::chrono::milliseconds(300), [this] {
+        // answered from the patched cache, mostly without a request
+        for (auto view : viewManager->visibleViews) {
+            call(actions::onShow, view);
+        }
+        if (!viewManager->isVisible(ViewName::MyEventPage)) {
+            // notifications follow the subscribed events
+            pollingService.pollNow("subscribed events");
+        }
+    });
 }
 
 void UiBridge::onExitEventLoop() {
     auto& self = *this;
 
+    diagnostics()->remove("ui");
+    diagnostics()->remove("polling");
+    watchdog.stop();
+    pollingService.stopAll();
+    pushedReload.stop();
+
     viewManager->onExitEventLoop();
 
     UiUtility::StylishLog::viewActionTriggered(logOrigin, "onStop");
     call(actions::onStop);
 }
 
+void UiBridge::onConnectivityChanged(bool online) {
+    UiUtility::StylishLog::general(logOrigin, online ? "back online" : "offline, cache-only");
+
+    if (!online) {
+        messageManager->showMessage("网络不可用，当前显示的是缓存数据",
+                                    MessageType::Warning,
+                                    std::chrono::seconds(5));
+        return;
+    }
+
+    messageManager->showMessage("网络已恢复", MessageType::Success);
+    // what is on screen may have come from the cache, load it again
+    for (auto view : viewManager->visibleViews) {
+        call(actions::onShow, view);
+    }
+}
+
 EVENTO_UI_END
\ No newline at end of file
@@ -2,10 +2,14 @@
 
 #include <Controller/Core/BasicView.h>
 #include <Controller/Core/GlobalAgent.hh>
+#include <Controller/Core/PollingService.h>
 #include <Controller/Core/UiBase.h>
+#include <Controller/Core/UiWatchdog.h>
 
 EVENTO_UI_START
 
+enum class PushState; // <Infrastructure/Network/NetworkClient.h>
+
 class UiBridge : GlobalAgent<::UiBridge> {
     friend class ViewManager;
     friend class AccountManager;
@@ -22,6 +26,14 @@ class UiBridge : GlobalAgent<::UiBridge> {
     std::shared_ptr<AccountManager> accountManager;
     std::shared_ptr<MessageManager> messageManager;
 
+    // reports handlers that block the event loop
+    UiWatchdog watchdog;
+
+    // background refreshes and UI timers, slowed down while hidden or idle
+    PollingService pollingService;
+    // coalesces the reloads of pushed changes arriving together
+    slint::Timer pushedReload;
+
     std::string logOrigin = "UiBridge";
 
 public:
@@ -35,6 +47,7 @@ public:
     ViewManager& getViewManager();
     AccountManager& getAccountManager();
     MessageManager& getMessageManager();
+    PollingService& getPollingService();
     [[deprecated("will lead to unknown behavior")]] slint::ComponentHandle<UiEntryName> getUiEntry();
 
     template<typename T>
@@ -57,11 +70,21 @@ private:
     void attachAllViews();
 
     void onEnterEventLoop();
+    // the window is up, start what can wait until now
+    void onFirstFrame();
     void onExitEventLoop();
+    // network client switched between online and cache-only
+    void onConnectivityChanged(bool online);
+    // change feed of the network client connected, dropped or found missing
+    void onPushStateChanged(PushState state);
+    // an event changed, the cached lists have it already
+    void onEventPushed();
 
     using Action = std::function<void(BasicView&)>;
     void call(Action& action);
     void call(Action& action, ViewName target);
+    // for `UiWatchdog` scopes
+    static const char* actionName(Action const& action);
 
     static struct actions {
         static inline Action onCreate = [](BasicView& view) { view.onCreate(); };
@@ -29,6 +29,12 @@ void AboutPage::onShow() {
     loadContributors();
 }
 
+void AboutPage::onHide() {
+    // avatars still queued are not worth the bandwidth once the page is gone
+    executor()->asyncExecute(networkClient()->cancelDownloads(DownloadPriority::Background),
+                             [] {});
+}
+
 void AboutPage::loadContributors() {
     auto& self = *this;
 
@@ -49,7 +55,10 @@ void AboutPage::loadContributors() {
 
             for (auto const& contributor : contributors) {
                 executor()->asyncExecute(
-                    networkClient()->getFile(contributor.avatar_url + "&s=40"),
+                    networkClient()->getFile(contributor.avatar_url + "&s=40",
+                                             CacheManager::cacheDir(),
+                                             true,
+                                             DownloadPriority::Background),
                     [&self = *this, &contributor, total, htmlUrl = contributor.html_url](
                         Result<std::filesystem::path> result) {
                         if (result.isErr()) {
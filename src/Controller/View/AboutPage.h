@@ -14,6 +14,7 @@ public:
 private:
     void onCreate() override;
     void onShow() override;
+    void onHide() override;
 
     void loadContributors();
     void checkUpdate(bool quite = false);
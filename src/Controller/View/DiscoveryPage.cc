@@ -5,6 +5,7 @@
 #include <Controller/View/DiscoveryPage.h>
 #include <Infrastructure/Network/NetworkClient.h>
 #include <Infrastructure/Network/ResponseStruct.h>
+#include <Infrastructure/Utils/StartupTimeline.h>
 #include <spdlog/spdlog.h>
 
 EVENTO_UI_START
@@ -22,45 +23,79 @@ void DiscoveryPage::onCreate() {
         spdlog::debug("navigate to DetailPage, current event is {}", eventStruct.summary.data());
         bridge.getViewManager().navigateTo(ViewName::DetailPage, eventStruct);
     });
+
+    // no rotation nobody can see
+    bridge.getPollingService().addPausable(
+        "slides",
+        [this] { timer.stop(); },
+        [this] {
+            if (bridge.getViewManager().isVisible(ViewName::DiscoveryPage)) {
+                timer.restart();
+            }
+        });
 }
 
 void DiscoveryPage::onShow() {
     loadActiveEvents();
     loadLatestEvents();
     loadHomeSlides();
+    // stopped in `onHide()`, a timer never started stays as it is
+    timer.restart();
+}
+
+void DiscoveryPage::onHide() {
+    timer.stop();
 }
 
 void DiscoveryPage::loadActiveEvents() {
     auto& self = *this;
-    self->set_active_events_state(PageState::Loading);
-    executor()->asyncExecute(networkClient()->getActiveEventList(),
-                             [&self = *this, this](Result<EventQueryRes> result) {
+    if (shownActive == 0) {
+        self->set_active_events_state(PageState::Loading);
+    }
+    auto fingerprint = std::make_shared<ResponseFingerprint>(
+        ResponseFingerprint{.seen = shownActive});
+    executor()->asyncExecute(networkClient()->getActiveEventList(1min, fingerprint.get()),
+                             [&self = *this, this, fingerprint](Result<EventQueryRes> result) {
                                  if (result.isErr()) {
                                      self->set_active_events_state(PageState::Error);
                                      self.bridge.getMessageManager()
                                          .showMessage(result.unwrapErr().what(), MessageType::Error);
                                      return;
                                  }
-                                 auto eventQueryRes = result.unwrap();
-                                 self->set_active_events(convert::from(eventQueryRes.elements));
+                                 if (!fingerprint->unchanged()) {
+                                     shownActive = fingerprint->delivered;
+                                     auto eventQueryRes = result.unwrap();
+                                     self->set_active_events(
+                                         convert::from(eventQueryRes.elements));
+                                 }
                                  self->set_active_events_state(PageState::Normal);
+                                 startupTimeline()->mark(StartupTimeline::FIRST_DATA);
                              });
 }
 
 void DiscoveryPage::loadLatestEvents() {
     auto& self = *this;
-    self->set_latest_events_state(PageState::Loading);
-    executor()->asyncExecute(networkClient()->getLatestEventList(),
-                             [&self = *this, this](Result<EventQueryRes> result) {
+    if (shownLatest == 0) {
+        self->set_latest_events_state(PageState::Loading);
+    }
+    auto fingerprint = std::make_shared<ResponseFingerprint>(
+        ResponseFingerprint{.seen = shownLatest});
+    executor()->asyncExecute(networkClient()->getLatestEventList(1min, fingerprint.get()),
+                             [&self = *this, this, fingerprint](Result<EventQueryRes> result) {
                                  if (result.isErr()) {
                                      self->set_latest_events_state(PageState::Error);
                                      self.bridge.getMessageManager()
                                          .showMessage(result.unwrapErr().what(), MessageType::Error);
                                      return;
                                  }
-                                 auto eventQueryRes = result.unwrap();
-                                 self->set_latest_events(convert::from(eventQueryRes.elements));
+                                 if (!fingerprint->unchanged()) {
+                                     shownLatest = fingerprint->delivered;
+                                     auto eventQueryRes = result.unwrap();
+                                     self->set_latest_events(
+                                         convert::from(eventQueryRes.elements));
+                                 }
                                  self->set_latest_events_state(PageState::Normal);
+                                 startupTimeline()->mark(StartupTimeline::FIRST_DATA);
                              });
 }
 
@@ -83,14 +118,17 @@ Task<void> DiscoveryPage::loadHomeSlidesTask() {
     auto list = result.unwrap();
     auto total = std::min(static_cast<std::size_t>(3), list.size());
     for (int i = 0; i < total; ++i) {
-        auto fileResult = co_await networkClient()->getFile(list[i].url);
+        auto fileResult = co_await networkClient()->getFile(list[i].url,
+                                                            CacheManager::cacheDir(),
+                                                            true,
+                                                            i == 0 ? DownloadPriority::Visible
+                                                                   : DownloadPriority::Prefetch);
         if (fileResult.isErr()) {
             spdlog::warn("image load failed: {}", fileResult.unwrapErr().what());
             co_return;
         }
 
-        auto image = slint::Image::load_from_path(
-            slint::SharedString(fileResult.unwrap().u8string()));
+        auto image = convert::from(fileResult.unwrap());
         slint::blocking_invoke_from_event_loop(
             [&, &self = *this]() { self->invoke_set_slide(i, image); });
     }
@@ -98,6 +136,7 @@ Task<void> DiscoveryPage::loadHomeSlidesTask() {
 
 void DiscoveryPage::slidesAutoRotation() {
     timer.start(slint::TimerMode::Repeated, 5s, [&self = *this] {
+        self.bridge.getPollingService().countWakeup("slides");
         self->set_image_index((self->get_image_index() + 1)
                               % static_cast<int>(self->get_carousel_source()->row_count()));
     });
@@ -3,6 +3,7 @@
 #include <Controller/Core/BasicView.h>
 #include <Controller/Core/GlobalAgent.hh>
 #include <Controller/Core/UiBase.h>
+#include <Infrastructure/Utils/Fingerprint.h>
 
 EVENTO_UI_START
 
@@ -14,12 +15,17 @@ private:
     slint::Timer timer;
     void onCreate() override;
     void onShow() override;
+    void onHide() override;
 
     void loadActiveEvents();
     void loadLatestEvents();
     void loadHomeSlides();
     Task<void> loadHomeSlidesTask();
     void slidesAutoRotation();
+
+    // of the lists shown, an unchanged response is neither decoded nor rebuilt into a model
+    Fingerprint shownActive = 0;
+    Fingerprint shownLatest = 0;
 };
 
 EVENTO_UI_END
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <Controller/AsyncExecutor.hh>
+#include <Controller/Convert.h>
 #include <Controller/Core/AccountManager.h>
 #include <Controller/UiBridge.h>
 #include <Controller/View/MenuOverlay.h>
@@ -48,11 +49,14 @@ Task<Result<slint::Image>> MenuOverlay::loadUserInfoTask() {
     }
     auto userInfo = result.unwrap();
     if (userInfo.avatar.has_value()) {
-        auto avatar = co_await networkClient()->getFile(*userInfo.avatar);
+        auto avatar = co_await networkClient()->getFile(*userInfo.avatar,
+                                                        CacheManager::cacheDir(),
+                                                        true,
+                                                        DownloadPriority::Visible);
         if (avatar.isErr()) {
             co_return Err(avatar.unwrapErr());
         }
-        co_return Ok(slint::Image::load_from_path(slint::SharedString(avatar.unwrap().u8string())));
+        co_return Ok(convert::from(avatar.unwrap()));
     }
     slint::blocking_invoke_from_event_loop([&] { refreshUserInfo(userInfo); });
     bridge.getAccountManager().userInfo() = std::move(userInfo);
@@ -65,15 +69,17 @@ void MenuOverlay::refreshUserInfo(UserInfoEntity const& userInfo) {
     self->set_user_signature(
         slint::SharedString(userInfo.biography.value_or("这个人很神秘，什么也没留下 ")));
     if (userInfo.avatar.has_value())
-        executor()->asyncExecute(networkClient()->getFile(*userInfo.avatar),
+        executor()->asyncExecute(networkClient()->getFile(*userInfo.avatar,
+                                                          CacheManager::cacheDir(),
+                                                          true,
+                                                          DownloadPriority::Visible),
                                  [&self = *this](Result<std::filesystem::path> result) {
                                      if (result.isErr()) {
                                          spdlog::error("Failed to get user avatar: {}",
                                                        result.unwrapErr().what());
                                          return;
                                      }
-                                     self->set_user_avatar(slint::Image::load_from_path(
-                                         slint::SharedString(result.unwrap().u8string())));
+                                     self->set_user_avatar(convert::from(result.unwrap()));
                                  });
 }
 
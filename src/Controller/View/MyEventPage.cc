@@ -6,6 +6,7 @@
 #include <Infrastructure/Network/ResponseStruct.h>
 #include <Infrastructure/Utils/Config.h>
 #include <Infrastructure/Utils/Tools.h>
+#include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
 EVENTO_UI_START
@@ -24,13 +25,15 @@ void MyEventPage::onCreate() {
 }
 
 void MyEventPage::onLogin() {
-    executor()->asyncExecute(
-        []() -> net::awaitable<Result<EventQueryRes>> {
-            return networkClient()->getSubscribedEvent();
-        },
-        [this](Result<EventQueryRes> result) { refreshUiModel(std::move(result)); },
-        1min,
-        AsyncExecutor::Delay | AsyncExecutor::Periodic);
+    // keeps notifications and the lists current, faster around the events' start and end
+    bridge.getPollingService().start("subscribed events", [this](auto done) {
+        auto fingerprint = std::make_shared<ResponseFingerprint>(
+            ResponseFingerprint{.seen = shownFingerprint});
+        executor()->asyncExecute(networkClient()->getSubscribedEvent(0min, fingerprint.get()),
+                                 [this, done, fingerprint](Result<EventQueryRes> result) {
+                                     done(refreshUiModel(std::move(result), *fingerprint));
+                                 });
+    });
 }
 
 void MyEventPage::onShow() {
@@ -39,35 +42,59 @@ void MyEventPage::onShow() {
 };
 
 void MyEventPage::onLogout() {
+    bridge.getPollingService().stop("subscribed events");
+    bridge.getPollingService().setBoundaries({});
+    shownFingerprint = 0;
     ipc()->deleteAllMessage();
 }
 
 void MyEventPage::loadSubscribedEvents() {
     auto& self = *this;
-    self->set_state(PageState::Loading);
+    if (shownFingerprint == 0) {
+        // anything shown stays until replaced, mostly by itself
+        self->set_state(PageState::Loading);
+    }
 
-    executor()->asyncExecute(networkClient()->getSubscribedEvent(0min),
-                             [&self = *this](Result<EventQueryRes> result) {
+    auto fingerprint = std::make_shared<ResponseFingerprint>(
+        ResponseFingerprint{.seen = shownFingerprint});
+    executor()->asyncExecute(networkClient()->getSubscribedEvent(0min, fingerprint.get()),
+                             [&self = *this, fingerprint](Result<EventQueryRes> result) {
                                  if (result.isErr()) {
                                      self->set_state(PageState::Error);
                                      self->set_error_message(
                                          slint::SharedString(result.unwrapErr().what()));
                                      return;
                                  }
-                                 self.refreshUiModel(std::move(result));
+                                 self.refreshUiModel(std::move(result), *fingerprint);
                              });
 }
 
-void MyEventPage::refreshUiModel(Result<EventQueryRes> result) {
+bool MyEventPage::refreshUiModel(Result<EventQueryRes> result,
+                                 ResponseFingerprint const& fingerprint) {
     auto& self = *this;
     if (result.isErr()) {
         self->set_state(PageState::Error);
         self.bridge.getMessageManager().showMessage(result.unwrapErr().what(), MessageType::Error);
-        return;
+        return false;
+    }
+    // nothing decoded, the models shown are current
+    if (fingerprint.unchanged()) {
+        self->set_state(PageState::Normal);
+        return false;
     }
 
     auto res = result.unwrap();
 
+    // a response that was not fingerprinted, e.g. the one API v1 puts together from several
+    auto delivered = fingerprint.delivered != 0
+                         ? fingerprint.delivered
+                         : fingerprintOf(nlohmann::json(res.elements).dump());
+    if (delivered == shownFingerprint) {
+        self->set_state(PageState::Normal);
+        return false;
+    }
+    shownFingerprint = delivered;
+
     std::vector<EventEntity> models[4];
     for (int i = 0; i < 3; i++) {
         std::copy_if(res.elements.begin(),
@@ -98,10 +125,22 @@ void MyEventPage::refreshUiModel(Result<EventQueryRes> result) {
         ipc()->cancelMessage(entity.id);
     }
 
+    std::vector<std::chrono::system_clock::time_point> boundaries;
+    for (auto const& entity : models[(int) EventState::SigningUp]) {
+        boundaries.push_back(std::chrono::system_clock::from_time_t(
+            parseIso8601Utc(entity.start.c_str())));
+    }
+    for (auto const& entity : models[(int) EventState::Active]) {
+        boundaries.push_back(
+            std::chrono::system_clock::from_time_t(parseIso8601Utc(entity.end.c_str())));
+    }
+    self.bridge.getPollingService().setBoundaries(std::move(boundaries));
+
     self->set_not_started_model(convert::from(models[(int) EventState::SigningUp]));
     self->set_active_model(convert::from(models[(int) EventState::Active]));
     self->set_completed_model(convert::from(models[(int) EventState::Completed]));
     self->set_state(PageState::Normal);
+    return true;
 }
 
 EVENTO_UI_END
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <Controller/Core/GlobalAgent.hh>
 #include <Controller/Core/UiBase.h>
 #include <Infrastructure/Network/ResponseStruct.h>
+#include <Infrastructure/Utils/Fingerprint.h>
 #include <Infrastructure/Utils/Result.h>
 
 EVENTO_UI_START
@@ -19,7 +20,11 @@ private:
     void onLogout() override;
 
     void loadSubscribedEvents();
-    void refreshUiModel(Result<EventQueryRes> result);
+    // returns whether the events differ from those shown
+    bool refreshUiModel(Result<EventQueryRes> result, ResponseFingerprint const& fingerprint);
+
+    // of the response shown, an unchanged one is neither decoded nor rebuilt into the models
+    Fingerprint shownFingerprint = 0;
 };
 
 EVENTO_UI_END
\ No newline at end of file
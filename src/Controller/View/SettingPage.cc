@@ -1,6 +1,8 @@
 #include <Controller/View/SettingPage.h>
+#include <Infrastructure/IPC/SocketClient.h>
 #include <Infrastructure/Network/NetworkClient.h>
 #include <Infrastructure/Utils/Config.h>
+#include <format>
 
 EVENTO_UI_START
 
@@ -33,6 +35,9 @@ void SettingPage::onCreate() {
         auto& setting = config["setting"].ref<toml::table>();
         setting.insert_or_assign("minimal-to-tray", self->get_minimal_to_tray());
         evento::settings.minimalToTray = self->get_minimal_to_tray();
+        if (evento::settings.minimalToTray && ipc()) {
+            ipc()->startTray();
+        }
     });
 
     self->on_notice_begin_changed([&self = *this]() {
@@ -59,9 +64,9 @@ void SettingPage::onCreate() {
         evento::settings.theme = self->get_theme_index();
     });
 
-    self->on_clear_cache([&self = *this]() {
+    self->on_clear_cache([this]() {
         networkClient()->clearCache();
-        self->set_cache_size(slint::SharedString(networkClient()->getTotalCacheSizeFormatString()));
+        refreshCacheInfo();
     });
 
     self->on_is_windows([]() {
@@ -82,7 +87,39 @@ void SettingPage::onShow() {
     self->set_auto_login(evento::settings.autoLogin);
     self->set_theme_index(evento::settings.theme);
 
+    refreshCacheInfo();
+}
+
+void SettingPage::refreshCacheInfo() {
+    auto& self = *this;
+
     self->set_cache_size(slint::SharedString(networkClient()->getTotalCacheSizeFormatString()));
+
+    std::string text;
+    std::size_t totalBytes = 0;
+    for (auto const& [prefix, stats] : networkClient()->cacheStats()) {
+        totalBytes += stats.bytes;
+        auto lookups = stats.hits + stats.misses;
+        text += std::format("{}\n    命中 {}/{}（{:.0f}%），过期 {}，淘汰 {}（{:.1f}KiB），"
+                            "{} 条 {:.1f}KiB，平均 {}s\n",
+                            prefix,
+                            stats.hits,
+                            lookups,
+                            lookups ? 100.0 * stats.hits / lookups : 0.0,
+                            stats.expirations,
+                            stats.evictions,
+                            static_cast<double>(stats.bytesEvicted) / 1024,
+                            stats.entries,
+                            static_cast<double>(stats.bytes) / 1024,
+                            stats.averageAge.count());
+    }
+    if (!text.empty()) {
+        text = std::format("内存缓存：{:.2f}MiB / {}MiB\n",
+                           static_cast<double>(totalBytes) / 1024 / 1024,
+                           CacheManager::MAX_CACHE_SIZE / 1024 / 1024)
+               + text;
+    }
+    self->set_cache_stats(slint::SharedString(text));
 }
 
 void SettingPage::onLogout() {
@@ -14,6 +14,9 @@ private:
     void onCreate() override;
     void onShow() override;
     void onLogout() override;
+
+    // disk cache size and the response cache counters
+    void refreshCacheInfo();
 };
 
 EVENTO_UI_END
\ No newline at end of file
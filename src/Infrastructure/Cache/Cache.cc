@@ -1,4 +1,7 @@
 #include <Infrastructure/Cache/Cache.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <filesystem>
 #include <format>
 #include <functional>
@@ -86,10 +89,13 @@ std::optional<std::filesystem::path> CacheManager::cacheDir() {
 }
 
 void CacheManager::insert(const std::string& key, const CacheEntry& entry) {
+    std::lock_guard lock(_mutex);
+    _stats[prefixOf(key)].bytesInserted += entry.size;
+
     auto it = _cacheMap.find(key);
     if (it != _cacheMap.end()) {
-        _cacheList.erase(it->second);
         _currentCacheSize -= it->second->second.size;
+        _cacheList.erase(it->second);
     }
 
     _cacheList.emplace_front(key, entry);
@@ -99,36 +105,103 @@ void CacheManager::insert(const std::string& key, const CacheEntry& entry) {
     while (_currentCacheSize > MAX_CACHE_SIZE) {
         auto last = _cacheList.end();
         --last;
+        auto& stats = _stats[prefixOf(last->first)];
+        ++stats.evictions;
+        stats.bytesEvicted += last->second.size;
         _currentCacheSize -= last->second.size;
         _cacheMap.erase(last->first);
         _cacheList.pop_back();
     }
 }
 
+std::size_t CacheManager::currentCacheSize() const {
+    std::lock_guard lock(_mutex);
+    return _currentCacheSize;
+}
+
 std::optional<CacheEntry> CacheManager::get(std::string const& key) {
-    if (_cacheMap.empty()) {
-        return std::nullopt;
-    }
+    std::lock_guard lock(_mutex);
+    auto& stats = _stats[prefixOf(key)];
 
     auto it = _cacheMap.find(key);
 
     if (it == _cacheMap.end()) {
+        ++stats.misses;
         return std::nullopt;
     }
 
+    // expired entries are kept for `getStale` until evicted by size
     if (isExpired(it->second->second)) {
-        _currentCacheSize -= _cacheMap[key]->second.size;
-        _cacheList.erase(_cacheMap[key]);
-        _cacheMap.erase(key);
+        ++stats.misses;
+        ++stats.expirations;
         return std::nullopt;
     }
 
+    ++stats.hits;
+    _cacheList.splice(_cacheList.begin(), _cacheList, it->second);
+
+    return it->second->second;
+}
+
+bool CacheManager::renew(std::string const& key,
+                         Fingerprint fingerprint,
+                         std::chrono::steady_clock::duration ttl) {
+    std::lock_guard lock(_mutex);
+    auto it = _cacheMap.find(key);
+    if (it == _cacheMap.end() || it->second->second.fingerprint != fingerprint) {
+        return false;
+    }
+    auto& entry = it->second->second;
+    entry.insertTime = std::chrono::steady_clock::now();
+    entry.ttl = ttl;
     _cacheList.splice(_cacheList.begin(), _cacheList, it->second);
+    return true;
+}
+
+std::optional<CacheEntry> CacheManager::getStale(std::string const& key) {
+    std::lock_guard lock(_mutex);
+    auto it = _cacheMap.find(key);
+
+    if (it == _cacheMap.end()) {
+        return std::nullopt;
+    }
 
     return it->second->second;
 }
 
+std::size_t CacheManager::patch(
+    std::function<CachePatch(std::string const& key, nlohmann::basic_json<>& data)> const&
+        visitor) {
+    std::lock_guard lock(_mutex);
+    std::size_t patched = 0;
+    for (auto it = _cacheList.begin(); it != _cacheList.end();) {
+        auto& [key, entry] = *it;
+        auto result = visitor(key, entry.data);
+        if (result == CachePatch::Unchanged) {
+            ++it;
+            continue;
+        }
+        ++patched;
+        ++_stats[prefixOf(key)].patches;
+        _currentCacheSize -= entry.size;
+        if (result == CachePatch::Invalidated) {
+            _cacheMap.erase(key);
+            it = _cacheList.erase(it);
+            continue;
+        }
+        auto dump = entry.data.dump();
+        entry.size = dump.size();
+        // no longer what the server sent, a fresh response differs from it
+        entry.fingerprint = fingerprintOf(dump);
+        _currentCacheSize += entry.size;
+        ++it;
+    }
+    return patched;
+}
+
 void CacheManager::clear() {
+    std::lock_guard lock(_mutex);
+    _stats.clear();
     _cacheList.clear();
     _cacheMap.clear();
     _currentCacheSize = 0;
@@ -138,9 +211,99 @@ void CacheManager::clear() {
 }
 
 void CacheManager::clearMemoryCache() {
+    std::lock_guard lock(_mutex);
     _cacheList.clear();
     _cacheMap.clear();
     _currentCacheSize = 0;
 }
 
+std::string CacheManager::prefixOf(std::string_view key) {
+    // "{url}|{verb}|{param}..." as made by `generateKey`
+    auto url = key.substr(0, key.find('|'));
+    std::string_view verb;
+    if (url.size() < key.size()) {
+        verb = key.substr(url.size() + 1);
+        verb = verb.substr(0, verb.find('|'));
+    }
+    int verbValue = 0;
+    std::from_chars(verb.data(), verb.data() + verb.size(), verbValue);
+
+    if (auto scheme = url.find("://"); scheme != std::string_view::npos) {
+        url.remove_prefix(scheme + 3);
+    }
+    if (auto query = url.find_first_of("?#"); query != std::string_view::npos) {
+        url = url.substr(0, query);
+    }
+    auto pathBegin = std::min(url.find('/'), url.size());
+
+    auto method = std::string(http::to_string(static_cast<http::verb>(verbValue)));
+    std::string prefix = std::format("{} {}", method, url.substr(0, pathBegin));
+    auto path = url.substr(pathBegin);
+    while (!path.empty()) {
+        auto begin = path.find_first_not_of('/');
+        if (begin == std::string_view::npos) {
+            break;
+        }
+        auto end = path.find('/', begin);
+        auto segment = path.substr(begin, end - begin);
+        bool numeric = std::all_of(segment.begin(), segment.end(), [](unsigned char c) {
+            return std::isdigit(c);
+        });
+        prefix += '/';
+        prefix += numeric ? "{id}" : segment;
+        path = end == std::string_view::npos ? std::string_view{} : path.substr(end);
+    }
+    return prefix;
+}
+
+std::map<std::string, CacheStats> CacheManager::snapshot() const {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard lock(_mutex);
+    auto result = _stats;
+    std::map<std::string, std::chrono::steady_clock::duration> ages;
+    for (auto const& [key, entry] : _cacheList) {
+        auto prefix = prefixOf(key);
+        auto& stats = result[prefix];
+        ++stats.entries;
+        stats.bytes += entry.size;
+        ages[prefix] += now - entry.insertTime;
+    }
+    for (auto const& [prefix, age] : ages) {
+        auto& stats = result[prefix];
+        stats.averageAge = std::chrono::duration_cast<std::chrono::seconds>(
+            age / static_cast<long long>(stats.entries));
+    }
+    return result;
+}
+
+std::string CacheManager::dump() const {
+    std::string result;
+    std::size_t totalBytes = 0;
+    for (auto const& [prefix, stats] : snapshot()) {
+        totalBytes += stats.bytes;
+        result += std::format("{}\n"
+                              "  {} hits, {} misses ({} expired), {} evictions, {} patches\n"
+                              "  {} entries, {:.1f}KiB, average age {}s, "
+                              "{:.1f}KiB inserted, {:.1f}KiB evicted\n",
+                              prefix,
+                              stats.hits,
+                              stats.misses,
+                              stats.expirations,
+                              stats.evictions,
+                              stats.patches,
+                              stats.entries,
+                              static_cast<double>(stats.bytes) / 1024,
+                              stats.averageAge.count(),
+                              static_cast<double>(stats.bytesInserted) / 1024,
+                              static_cast<double>(stats.bytesEvicted) / 1024);
+    }
+    if (result.empty()) {
+        return "nothing cached yet\n";
+    }
+    return std::format("{:.2f}MiB of {}MiB in use\n",
+                       static_cast<double>(totalBytes) / 1024 / 1024,
+                       MAX_CACHE_SIZE / 1024 / 1024)
+           + result;
+}
+
 } // namespace evento
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <Infrastructure/Utils/Fingerprint.h>
 #include <boost/beast/http.hpp>
 #include <boost/url.hpp>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <list>
+#include <map>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
 
 namespace evento {
@@ -19,8 +25,32 @@ struct CacheEntry {
     std::chrono::steady_clock::time_point insertTime;
     std::chrono::steady_clock::duration ttl;
     std::size_t size; //cache size
+    Fingerprint fingerprint = 0; // of the response body `data` came from
 };
 
+// counters of the cache entries sharing a key prefix, see `CacheManager::prefixOf`
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;      // including expirations
+    std::uint64_t expirations = 0; // found but past their ttl
+    std::uint64_t evictions = 0;   // dropped to stay below `MAX_CACHE_SIZE`
+    std::uint64_t patches = 0;     // updated or dropped by `CacheManager::patch`
+    std::uint64_t bytesInserted = 0;
+    std::uint64_t bytesEvicted = 0;
+    // entries currently cached
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+    std::chrono::seconds averageAge{};
+};
+
+// what a visitor of `CacheManager::patch` did to an entry
+enum class CachePatch {
+    Unchanged,
+    Updated,
+    Invalidated, // cannot be updated, drop it
+};
+
+// Safe to use from any thread.
 class CacheManager {
 public:
     static std::string generateKey(http::verb verb,
@@ -35,20 +65,48 @@ public:
 
     void insert(const std::string& key, const CacheEntry& entry);
 
-    static std::size_t currentCacheSize() { return _currentCacheSize; }
+    // bytes held by this cache
+    [[nodiscard]] std::size_t currentCacheSize() const;
 
     std::optional<CacheEntry> get(std::string const& key);
+    // a response matching the cached one by `fingerprint` renews the entry for `ttl`,
+    // returns whether it did
+    bool renew(std::string const& key,
+               Fingerprint fingerprint,
+               std::chrono::steady_clock::duration ttl);
+    // like `get`, but expired entries are returned as well,
+    // used as a fallback when the backend cannot be reached
+    std::optional<CacheEntry> getStale(std::string const& key);
+
+    // rewrite cached data in place, e.g. for a change pushed by the server,
+    // `visitor` runs under the lock for every entry, updated entries keep their age
+    // and get a fingerprint of their new data, returns the number of entries updated or dropped
+    std::size_t patch(
+        std::function<CachePatch(std::string const& key, nlohmann::basic_json<>& data)> const&
+            visitor);
 
     void clear();
     void clearMemoryCache();
 
+    // "GET host/api/v2/client/event/{id}" for the key of "https://host/api/v2/client/event/42",
+    // numeric path segments are folded and queries dropped, so one endpoint shares its counters
+    static std::string prefixOf(std::string_view key);
+
+    // counters since start or the last `clear`, by prefix
+    [[nodiscard]] std::map<std::string, CacheStats> snapshot() const;
+    // human readable table of `snapshot`, for the diagnostics dump
+    [[nodiscard]] std::string dump() const;
+
     static constexpr size_t MAX_CACHE_SIZE = 64 * 1024 * 1024;
 
 private:
+    mutable std::mutex _mutex;
+    // counters only, `entries`, `bytes` and `averageAge` are summed up by `snapshot`
+    std::map<std::string, CacheStats> _stats;
     std::list<std::pair<std::string, CacheEntry>> _cacheList{};
     std::unordered_map<std::string, std::list<std::pair<std::string, CacheEntry>>::iterator>
         _cacheMap{};
-    inline static std::size_t _currentCacheSize = 0;
+    std::size_t _currentCacheSize = 0;
 };
 
 } // namespace evento
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include <Infrastructure/Cache/Cache.h>
+#include <Infrastructure/Cache/PixelCache.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace evento {
+
+namespace fs = std::filesystem;
+
+constexpr char PIXEL_CACHE_MAGIC[4] = {'E', 'V', 'P', 'X'};
+constexpr char PIXEL_CACHE_EXT[] = ".rgba";
+
+static_assert(sizeof(PixelCache::Header) == 32, "pixel cache header must stay packed");
+
+MappedPixels::MappedPixels(MappedPixels&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedPixels& MappedPixels::operator=(MappedPixels&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        _mapping = std::exchange(other._mapping, nullptr);
+        _mappingSize = std::exchange(other._mappingSize, 0);
+#ifdef PLATFORM_WINDOWS
+        _fileMapping = std::exchange(other._fileMapping, nullptr);
+#endif
+        _pixels = std::exchange(other._pixels, nullptr);
+        _width = std::exchange(other._width, 0);
+        _height = std::exchange(other._height, 0);
+        _stride = std::exchange(other._stride, 0);
+    }
+    return *this;
+}
+
+MappedPixels::~MappedPixels() {
+    unmap();
+}
+
+void MappedPixels::unmap() {
+    if (!_mapping) {
+        return;
+    }
+#ifdef PLATFORM_WINDOWS
+    UnmapViewOfFile(_mapping);
+    CloseHandle(_fileMapping);
+    _fileMapping = nullptr;
+#else
+    munmap(_mapping, _mappingSize);
+#endif
+    _mapping = nullptr;
+    _pixels = nullptr;
+}
+
+std::optional<fs::path> PixelCache::cacheDir() {
+    auto dir = CacheManager::cacheDir();
+    if (!dir) {
+        return std::nullopt;
+    }
+    auto pixelDir = *dir / "pixels";
+    std::error_code ec;
+    if (!fs::is_directory(pixelDir, ec)) {
+        fs::create_directories(pixelDir, ec);
+        if (ec) {
+            spdlog::warn("Failed to create pixel cache directory: {}", ec.message());
+            return std::nullopt;
+        }
+    }
+    return pixelDir;
+}
+
+std::optional<std::uint64_t> PixelCache::digest(fs::path const& source) {
+    std::error_code ec;
+    auto size = fs::file_size(source, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    auto mtime = fs::last_write_time(source, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    // FNV-1a
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](const void* data, std::size_t length) {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < length; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    };
+    auto name = source.filename().string();
+    auto ticks = mtime.time_since_epoch().count();
+    mix(name.data(), name.size());
+    mix(&size, sizeof(size));
+    mix(&ticks, sizeof(ticks));
+    return hash;
+}
+
+fs::path PixelCache::entryPath(fs::path const& dir, fs::path const& source) {
+    return dir / (source.stem().string() + PIXEL_CACHE_EXT);
+}
+
+std::optional<MappedPixels> PixelCache::load(fs::path const& source) {
+    auto dir = cacheDir();
+    auto sourceDigest = digest(source);
+    if (!dir || !sourceDigest) {
+        return std::nullopt;
+    }
+    auto path = entryPath(*dir, source);
+
+    MappedPixels pixels;
+    Header header{};
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = CreateFileW(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)
+        || static_cast<std::uint64_t>(fileSize.QuadPart) < sizeof(Header)) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return std::nullopt;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return std::nullopt;
+    }
+    pixels._fileMapping = mapping;
+    pixels._mapping = view;
+    pixels._mappingSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    void* view = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return std::nullopt;
+    }
+    pixels._mapping = view;
+    pixels._mappingSize = static_cast<std::size_t>(st.st_size);
+#endif
+
+    std::memcpy(&header, pixels._mapping, sizeof(Header));
+    auto expectedSize = sizeof(Header)
+                        + static_cast<std::uint64_t>(header.stride) * header.height;
+    if (std::memcmp(header.magic, PIXEL_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != FORMAT_VERSION || header.digest != *sourceDigest
+        || header.stride < static_cast<std::uint64_t>(header.width) * 4
+        || pixels._mappingSize < expectedSize) {
+        spdlog::debug("Pixel cache entry is stale: {}", path.string());
+        return std::nullopt;
+    }
+
+    pixels._pixels = static_cast<const std::uint8_t*>(pixels._mapping) + sizeof(Header);
+    pixels._width = header.width;
+    pixels._height = header.height;
+    pixels._stride = header.stride;
+
+    // keep recently used entries away from eviction
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    return pixels;
+}
+
+bool PixelCache::store(fs::path const& source,
+                       std::uint32_t width,
+                       std::uint32_t height,
+                       std::uint32_t stride,
+                       const std::uint8_t* pixels) {
+    auto dir = cacheDir();
+    auto sourceDigest = digest(source);
+    if (!dir || !sourceDigest || !pixels || stride < width * 4) {
+        return false;
+    }
+
+    Header header{};
+    std::memcpy(header.magic, PIXEL_CACHE_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.width = width;
+    header.height = height;
+    header.stride = stride;
+    header.digest = *sourceDigest;
+
+    auto path = entryPath(*dir, source);
+    // write aside and rename, so that a concurrent `load` never maps a half-written entry
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    auto payloadSize = static_cast<std::uintmax_t>(stride) * height;
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            spdlog::warn("Failed to open file: {}", tmpPath.string());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(pixels),
+                   static_cast<std::streamsize>(payloadSize));
+        if (!file) {
+            spdlog::warn("Failed to save file: {}", tmpPath.string());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::uintmax_t replacedSize = fs::exists(path, ec) ? fs::file_size(path, ec) : 0;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        spdlog::warn("Failed to save pixel cache entry: {}", ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    std::lock_guard lock(_mutex);
+    if (_currentSize) {
+        *_currentSize += sizeof(Header) + payloadSize - std::min(replacedSize, *_currentSize);
+    }
+    trim(*dir);
+    return true;
+}
+
+void PixelCache::trim(fs::path const& dir) {
+    std::error_code ec;
+    std::vector<std::pair<fs::file_time_type, fs::directory_entry>> entries;
+    auto scan = [&] {
+        entries.clear();
+        std::uintmax_t size = 0;
+        for (auto const& entry : fs::directory_iterator(dir, ec)) {
+            if (!entry.is_regular_file(ec) || entry.path().extension() != PIXEL_CACHE_EXT) {
+                continue;
+            }
+            size += entry.file_size(ec);
+            entries.emplace_back(entry.last_write_time(ec), entry);
+        }
+        return size;
+    };
+
+    if (!_currentSize) {
+        _currentSize = scan();
+    }
+    if (*_currentSize <= MAX_DISK_SIZE) {
+        return;
+    }
+
+    _currentSize = scan();
+    std::sort(entries.begin(), entries.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.first < rhs.first;
+    });
+    for (auto const& [_, entry] : entries) {
+        if (*_currentSize <= MAX_DISK_SIZE / 4 * 3) {
+            break;
+        }
+        auto size = entry.file_size(ec);
+        if (fs::remove(entry.path(), ec)) {
+            *_currentSize -= std::min(size, *_currentSize);
+        }
+    }
+    spdlog::debug("Pixel cache trimmed to {} bytes", *_currentSize);
+}
+
+void PixelCache::remove(fs::path const& source) {
+    std::lock_guard lock(_mutex);
+    auto dir = cacheDir();
+    if (!dir) {
+        return;
+    }
+    std::error_code ec;
+    auto path = entryPath(*dir, source);
+    auto size = fs::file_size(path, ec);
+    if (!ec && fs::remove(path, ec) && _currentSize) {
+        *_currentSize -= std::min(size, *_currentSize);
+    }
+}
+
+void PixelCache::clear() {
+    std::lock_guard lock(_mutex);
+    if (auto dir = cacheDir()) {
+        std::error_code ec;
+        fs::remove_all(*dir, ec);
+    }
+    _currentSize = 0;
+}
+
+PixelCache* pixelCache() {
+    static PixelCache s_instance;
+    return &s_instance;
+}
+
+} // namespace evento
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
+namespace evento {
+
+// read-only view of decoded RGBA8 pixels, backed by a memory mapping of the cache file
+class MappedPixels {
+public:
+    MappedPixels(const MappedPixels&) = delete;
+    MappedPixels& operator=(const MappedPixels&) = delete;
+    MappedPixels(MappedPixels&& other) noexcept;
+    MappedPixels& operator=(MappedPixels&& other) noexcept;
+    ~MappedPixels();
+
+    [[nodiscard]] std::uint32_t width() const { return _width; }
+    [[nodiscard]] std::uint32_t height() const { return _height; }
+    // bytes per row, at least `width() * 4`
+    [[nodiscard]] std::uint32_t stride() const { return _stride; }
+    [[nodiscard]] const std::uint8_t* data() const { return _pixels; }
+
+private:
+    MappedPixels() = default;
+    void unmap();
+
+    void* _mapping = nullptr;
+    std::size_t _mappingSize = 0;
+#ifdef PLATFORM_WINDOWS
+    void* _fileMapping = nullptr;
+#endif
+    const std::uint8_t* _pixels = nullptr;
+    std::uint32_t _width = 0;
+    std::uint32_t _height = 0;
+    std::uint32_t _stride = 0;
+
+    friend class PixelCache;
+};
+
+// On-disk cache of pre-decoded images, so that a cold start does not pay the decode cost again.
+// Every file downloaded by `NetworkClient::getFile` may have a sibling `<stem>.rgba` in
+// `pixels/` under `CacheManager::cacheDir()`, holding a small header and the raw pixels.
+class PixelCache {
+public:
+    struct Header {
+        char magic[4];          // "EVPX"
+        std::uint32_t version;  // FORMAT_VERSION
+        std::uint32_t width;    // in pixels
+        std::uint32_t height;   // in pixels
+        std::uint32_t stride;   // in bytes
+        std::uint32_t reserved; // keep `digest` 8-byte aligned
+        std::uint64_t digest;   // identity of the source file, see `digest()`
+    };
+
+    static std::optional<std::filesystem::path> cacheDir();
+
+    // cheap identity of the encoded source file (name, size and mtime), no content hashing
+    static std::optional<std::uint64_t> digest(std::filesystem::path const& source);
+
+    // map the decoded pixels of `source`, `std::nullopt` if missing or stale
+    std::optional<MappedPixels> load(std::filesystem::path const& source);
+
+    // `pixels` holds `height` rows of `stride` bytes in RGBA8 order
+    bool store(std::filesystem::path const& source,
+               std::uint32_t width,
+               std::uint32_t height,
+               std::uint32_t stride,
+               const std::uint8_t* pixels);
+
+    // drop the decoded pixels of `source`, e.g. when `source` itself is removed
+    void remove(std::filesystem::path const& source);
+    void clear();
+
+    // budget of the pixel cache alone, `getFile` files are not counted
+    static constexpr std::uintmax_t MAX_DISK_SIZE = 256 * 1024 * 1024;
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+private:
+    static std::filesystem::path entryPath(std::filesystem::path const& dir,
+                                           std::filesystem::path const& source);
+    // evict least recently used entries until below 3/4 of the budget
+    void trim(std::filesystem::path const& dir);
+
+    std::mutex _mutex;
+    std::optional<std::uintmax_t> _currentSize;
+};
+
+PixelCache* pixelCache();
+
+} // namespace evento
@@ -0,0 +1,299 @@
+#include <Infrastructure/IPC/NotificationScheduler.h>
+#include <Infrastructure/Utils/Diagnostics.h>
+#include <boost/asio/post.hpp>
+#include <format>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+namespace evento {
+
+namespace {
+
+std::int64_t toSeconds(NotificationScheduler::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+NotificationScheduler::Clock::time_point fromSeconds(std::int64_t seconds) {
+    return NotificationScheduler::Clock::time_point(std::chrono::seconds(seconds));
+}
+
+} // namespace
+
+std::shared_ptr<NotificationScheduler> NotificationScheduler::create(
+    net::io_context& ioc, Deliver deliver, std::optional<std::filesystem::path> file) {
+    std::shared_ptr<NotificationScheduler> scheduler(
+        new NotificationScheduler(ioc, std::move(deliver), std::move(file)));
+    std::weak_ptr<NotificationScheduler> weak = scheduler;
+    net::post(ioc, [weak] {
+        if (auto self = weak.lock()) {
+            // overdue while the app was closed, or due now
+            self->fire();
+        }
+    });
+    diagnostics()->add("notifications", [weak]() -> std::string {
+        auto self = weak.lock();
+        if (!self) {
+            return {};
+        }
+        auto stats = self->stats();
+        return std::format("  {} pending, {} heap entries, {} timer armed, {} delivered\n",
+                           stats.pending,
+                           stats.heapSize,
+                           stats.armedTimers,
+                           stats.delivered);
+    });
+    return scheduler;
+}
+
+NotificationScheduler::NotificationScheduler(net::io_context& ioc,
+                                             Deliver deliver,
+                                             std::optional<std::filesystem::path> file)
+    : _ioc(ioc)
+    , _deliver(std::move(deliver))
+    , _file(std::move(file))
+    , _timer(ioc) {
+    // nothing runs in the io thread yet
+    load();
+    updateStats();
+}
+
+NotificationScheduler::~NotificationScheduler() {
+    // the posted save cannot run anymore, nothing else holds the scheduler
+    if (_savePosted) {
+        save();
+    }
+}
+
+void NotificationScheduler::schedule(int id, std::string message, Clock::time_point time) {
+    net::post(_ioc,
+              [weak = weak_from_this(), id, message = std::move(message), time]() mutable {
+                  if (auto self = weak.lock()) {
+                      self->doSchedule(id, std::move(message), time);
+                  }
+              });
+}
+
+void NotificationScheduler::cancel(int id) {
+    net::post(_ioc, [weak = weak_from_this(), id] {
+        if (auto self = weak.lock()) {
+            self->doCancel(id);
+        }
+    });
+}
+
+void NotificationScheduler::cancelAll() {
+    net::post(_ioc, [weak = weak_from_this()] {
+        if (auto self = weak.lock()) {
+            if (self->_pending.empty()) {
+                return;
+            }
+            self->_pending.clear();
+            self->_heap = {};
+            self->arm();
+            self->changed();
+        }
+    });
+}
+
+NotificationScheduler::Stats NotificationScheduler::stats() const {
+    std::lock_guard lock(_statsMutex);
+    return _stats;
+}
+
+void NotificationScheduler::doSchedule(int id, std::string message, Clock::time_point time) {
+    // as precise as persisted
+    time = std::chrono::floor<std::chrono::seconds>(time);
+    if (time < Clock::now() - GRACE) {
+        return;
+    }
+    if (auto delivered = _delivered.find(id);
+        delivered != _delivered.end() && delivered->second == time) {
+        return;
+    }
+    auto [it, inserted] = _pending.try_emplace(id);
+    auto& pending = it->second;
+    if (!inserted && pending.time == time) {
+        // the refresh of an unchanged event, the heap entry stays valid
+        if (pending.message != message) {
+            pending.message = std::move(message);
+            changed();
+        }
+        return;
+    }
+    pending.time = time;
+    pending.message = std::move(message);
+    push(id, pending);
+    arm();
+    changed();
+}
+
+void NotificationScheduler::doCancel(int id) {
+    // its heap entry is skipped once it surfaces
+    if (_pending.erase(id) > 0) {
+        arm();
+        changed();
+    }
+}
+
+void NotificationScheduler::push(int id, Pending& pending) {
+    pending.generation = ++_generation;
+    _heap.push({.time = pending.time, .id = id, .generation = pending.generation});
+
+    // rebuild once outdated entries dominate, so that rescheduling cannot grow the heap
+    if (_heap.size() > 2 * _pending.size() + 16) {
+        std::vector<HeapEntry> entries;
+        entries.reserve(_pending.size());
+        for (auto const& [pendingId, entry] : _pending) {
+            entries.push_back(
+                {.time = entry.time, .id = pendingId, .generation = entry.generation});
+        }
+        _heap = decltype(_heap)(std::greater<>(), std::move(entries));
+    }
+}
+
+bool NotificationScheduler::outdated(HeapEntry const& entry) const {
+    auto it = _pending.find(entry.id);
+    return it == _pending.end() || it->second.generation != entry.generation;
+}
+
+void NotificationScheduler::arm() {
+    while (!_heap.empty() && outdated(_heap.top())) {
+        _heap.pop();
+    }
+    if (_heap.empty()) {
+        if (_armedAt) {
+            _timer.cancel();
+            _armedAt.reset();
+        }
+        updateStats();
+        return;
+    }
+    auto next = _heap.top().time;
+    if (_armedAt == next) {
+        updateStats();
+        return;
+    }
+    // cancels the wait for the previous time
+    _timer.expires_at(next);
+    _armedAt = next;
+    _timer.async_wait([weak = weak_from_this()](boost::system::error_code ec) {
+        if (ec == net::error::operation_aborted) {
+            return;
+        }
+        if (auto self = weak.lock()) {
+            self->_armedAt.reset();
+            self->fire();
+        }
+    });
+    updateStats();
+}
+
+void NotificationScheduler::fire() {
+    auto now = Clock::now();
+    bool delivered = false;
+    // those due at once are delivered in the same turn, and sent to the tray as one batch
+    while (!_heap.empty() && _heap.top().time <= now) {
+        auto entry = _heap.top();
+        _heap.pop();
+        auto it = _pending.find(entry.id);
+        if (it == _pending.end() || it->second.generation != entry.generation) {
+            continue;
+        }
+        if (entry.time >= now - GRACE) {
+            _deliver(std::move(it->second.message));
+            ++_deliveredCount;
+        }
+        _delivered[entry.id] = entry.time;
+        _pending.erase(it);
+        delivered = true;
+    }
+    std::erase_if(_delivered, [now](auto const& entry) { return entry.second < now - HISTORY; });
+    arm();
+    if (delivered) {
+        changed();
+    }
+}
+
+void NotificationScheduler::changed() {
+    updateStats();
+    if (!_file || _savePosted) {
+        return;
+    }
+    // once per turn of the io loop, however many notifications changed in it
+    _savePosted = true;
+    net::post(_ioc, [weak = weak_from_this()] {
+        if (auto self = weak.lock()) {
+            self->_savePosted = false;
+            self->save();
+        }
+    });
+}
+
+void NotificationScheduler::load() {
+    if (!_file) {
+        return;
+    }
+    std::ifstream in(*_file);
+    if (!in.is_open()) {
+        return;
+    }
+    try {
+        auto state = nlohmann::json::parse(in);
+        for (auto const& entry : state.at("delivered")) {
+            auto time = fromSeconds(entry.at("time").get<std::int64_t>());
+            _delivered[entry.at("id").get<int>()] = time;
+        }
+        for (auto const& entry : state.at("pending")) {
+            auto id = entry.at("id").get<int>();
+            auto& pending = _pending[id];
+            pending.time = fromSeconds(entry.at("time").get<std::int64_t>());
+            pending.message = entry.at("message").get<std::string>();
+            push(id, pending);
+        }
+    } catch (std::exception const& e) {
+        spdlog::warn("Ignoring notifications in {}: {}", _file->string(), e.what());
+        _pending.clear();
+        _delivered.clear();
+        _heap = {};
+    }
+}
+
+void NotificationScheduler::save() {
+    auto state = nlohmann::json{{"pending", nlohmann::json::array()},
+                                {"delivered", nlohmann::json::array()}};
+    for (auto const& [id, pending] : _pending) {
+        state["pending"].push_back(
+            {{"id", id}, {"time", toSeconds(pending.time)}, {"message", pending.message}});
+    }
+    for (auto const& [id, time] : _delivered) {
+        state["delivered"].push_back({{"id", id}, {"time", toSeconds(time)}});
+    }
+
+    // replaced at once, a crash mid-write leaves the previous state
+    auto temporary = *_file;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << state.dump();
+        if (!out) {
+            spdlog::warn("Cannot write notifications to {}", temporary.string());
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, *_file, ec);
+    if (ec) {
+        spdlog::warn("Cannot write notifications to {}: {}", _file->string(), ec.message());
+    }
+}
+
+void NotificationScheduler::updateStats() {
+    std::lock_guard lock(_statsMutex);
+    _stats.pending = _pending.size();
+    _stats.heapSize = _heap.size();
+    _stats.armedTimers = _armedAt ? 1 : 0;
+    _stats.delivered = _deliveredCount;
+}
+
+} // namespace evento
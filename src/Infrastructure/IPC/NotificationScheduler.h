@@ -0,0 +1,106 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/system_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace evento {
+
+namespace net = boost::asio;
+
+// Notifications due at a wall-clock time, keyed by event id, behind a single timer armed
+// for the earliest one. Pending notifications are in a hash map, their due times in a
+// min-heap whose outdated entries are skipped when they surface:
+// - scheduling an id again at the same time only replaces the text, O(1)
+// - cancelling is O(1), moving an id to another time pushes one heap entry, O(log n)
+// so refreshing the same events every minute leaves the timer and the heap as they are.
+//
+// Every notification is delivered once: ids delivered at a time are remembered, and with
+// `file` set the pending and delivered ones survive restarts. Notifications overdue by more
+// than `GRACE`, e.g. after the app was closed, are dropped.
+//
+// The public members are thread-safe, the work runs in the io thread of `ioc`.
+class NotificationScheduler : public std::enable_shared_from_this<NotificationScheduler> {
+public:
+    using Clock = std::chrono::system_clock;
+    // called in the io thread
+    using Deliver = std::function<void(std::string message)>;
+
+    static constexpr auto GRACE = std::chrono::minutes(10);
+    // delivered ids are remembered this long
+    static constexpr auto HISTORY = std::chrono::days(2);
+
+    static std::shared_ptr<NotificationScheduler> create(
+        net::io_context& ioc, Deliver deliver, std::optional<std::filesystem::path> file);
+    ~NotificationScheduler();
+
+    // replaces what is pending for `id`
+    void schedule(int id, std::string message, Clock::time_point time);
+    void cancel(int id);
+    void cancelAll();
+
+    struct Stats {
+        std::size_t pending;
+        std::size_t heapSize;     // pending plus outdated entries not skipped yet
+        std::size_t armedTimers;  // 0 or 1
+        std::uint64_t delivered;
+    };
+    [[nodiscard]] Stats stats() const;
+
+private:
+    NotificationScheduler(net::io_context& ioc,
+                          Deliver deliver,
+                          std::optional<std::filesystem::path> file);
+
+    struct Pending {
+        Clock::time_point time;
+        std::string message;
+        std::uint64_t generation; // of the heap entry that is current
+    };
+    struct HeapEntry {
+        Clock::time_point time;
+        int id;
+        std::uint64_t generation;
+
+        bool operator>(HeapEntry const& other) const { return time > other.time; }
+    };
+
+    // io thread only
+    void doSchedule(int id, std::string message, Clock::time_point time);
+    void doCancel(int id);
+    void push(int id, Pending& pending);
+    bool outdated(HeapEntry const& entry) const;
+    void arm();
+    void fire();
+    void changed();
+    void load();
+    void save();
+    void updateStats();
+
+    net::io_context& _ioc;
+    Deliver _deliver;
+    std::optional<std::filesystem::path> _file;
+    net::system_timer _timer;
+    std::optional<Clock::time_point> _armedAt;
+    std::unordered_map<int, Pending> _pending;
+    std::unordered_map<int, Clock::time_point> _delivered; // id -> due time it was shown for
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<>> _heap;
+    std::uint64_t _generation = 0;
+    std::uint64_t _deliveredCount = 0;
+    bool _savePosted = false;
+
+    mutable std::mutex _statsMutex;
+    Stats _stats{};
+};
+
+} // namespace evento
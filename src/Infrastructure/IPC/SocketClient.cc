@@ -1,69 +1,99 @@
 #include <Controller/AsyncExecutor.hh>
+#include <Infrastructure/Cache/Cache.h>
 #include <Infrastructure/IPC/SocketClient.h>
 #include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/asio/use_future.hpp>
 #include <boost/dll.hpp>
 #include <boost/system.hpp>
 #include <spdlog/spdlog.h>
+#include <utility>
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#endif
 
 namespace evento {
 
 namespace bp = boost::process;
+using namespace std::chrono_literals;
 
-SocketClient::SocketClient(std::unordered_map<std::string_view, std::function<void()>> actions)
+SocketClient::SocketClient(std::unordered_map<MessageType, std::function<void()>> actions)
     : _actions(std::move(actions)) {
+    _stopped = std::make_shared<net::steady_timer>(executor()->getIoContext(),
+                                                   net::steady_timer::time_point::max());
+    _running = std::shared_ptr<void>(this, [stopped = _stopped](void*) {
+        stopped->expires_at(net::steady_timer::time_point::min());
+    });
+    auto file = CacheManager::cacheDir();
+    // the scheduler may outlive `this`, it delivers only until `shutdown()` ran
+    _notifications = NotificationScheduler::create(
+        executor()->getIoContext(),
+        [this, weak = std::weak_ptr(_running)](std::string message) {
+            auto running = weak.lock();
+            if (!running) {
+                return;
+            }
+            net::co_spawn(
+                executor()->getIoContext(),
+                [this, running, message = std::move(message)]() -> net::awaitable<void> {
+                    co_await send(MessageType::Notify, message);
+                },
+                net::detached);
+        },
+        file ? std::optional(*file / "notifications.json") : std::nullopt);
     if (!_instance)
         _instance = this;
 }
 
 SocketClient::~SocketClient() {
-    close();
-}
-
-void SocketClient::startTray() {
-    bp::ipstream pipe;
-    boost::filesystem::path trayPath = boost::dll::program_location().parent_path();
-#ifdef EVENTO_DEBUG
-    trayPath /= "../Tray/Debug";
-#endif
-#ifdef PLATFORM_WINDOWS
-    trayPath /= "sast-evento-tray.exe";
-#else
-    trayPath /= "sast-evento-tray";
-#endif
-
-    std::error_code ec;
-    bp::child tray(trayPath, bp::std_in<bp::close, bp::std_out> pipe, bp::std_err > bp::null, ec);
-    if (ec) {
-        spdlog::error("Failed to start tray: file = {}, reason = {}",
-                      trayPath.string(),
-                      ec.message());
-        return;
+    auto& ioc = executor()->getIoContext();
+    if (ioc.stopped()) {
+        // e.g. after a signal, the coroutines left never resume and nothing else uses the
+        // socket, a future of the io context would never be ready
+        _closing = true;
+        close();
+        _running.reset();
+    } else {
+        // the socket is used by the io thread, and so is `this` by the coroutines there
+        auto closed = net::co_spawn(ioc, shutdown(), net::use_future);
+        // as long as a start attempt may take
+        if (closed.wait_for(3 * TRAY_TIMEOUT) != std::future_status::ready) {
+            spdlog::warn("IPC did not shut down in time");
+        }
     }
-
-    std::string line;
-    if (!pipe || !std::getline(pipe, line) || line.empty()) {
-        spdlog::error("Failed to start tray: file = {}, reason = {}", trayPath.string(), "no port");
-        return;
+    if (_instance == this) {
+        _instance = nullptr;
     }
-    _tray = std::move(tray);
+}
 
-    spdlog::info("Tray started at: {}", line);
+net::awaitable<void> SocketClient::shutdown() {
+    _closing = true;
+    // wakes a pending read or write
+    close();
+    auto stopped = _stopped;
+    _running.reset();
+    co_await stopped->async_wait(net::as_tuple(net::use_awaitable));
+}
 
-    net::co_spawn(executor()->getIoContext(),
-                  connect(std::strtol(line.c_str(), nullptr, 10)),
-                  net::detached);
+void SocketClient::startTray() {
+    // the tray state belongs to the io thread
+    net::co_spawn(executor()->getIoContext(), ensureTray(), net::detached);
 }
 
 void SocketClient::exitTray() {
+    auto& ioc = executor()->getIoContext();
+    // nothing runs on a stopped io context, a future of it is never ready
+    if (!ioc.stopped()) {
+        auto stopped = net::co_spawn(ioc, stopTray(), net::use_future);
+        if (stopped.wait_for(2 * TRAY_TIMEOUT) == std::future_status::ready) {
+            return;
+        }
+        spdlog::warn("Tray did not stop in time");
+    }
     std::error_code ec;
-    if (_socket) {
-        net::co_spawn(_socket->get_executor(), send("EXIT"), net::detached);
-        _tray.wait(ec);
-    } else {
+    if (_tray.valid()) {
         _tray.terminate(ec);
     }
-    auto exit_code = _tray.exit_code();
-    spdlog::info("Tray exited with code: {}", exit_code);
 }
 
 void SocketClient::showOrUpdateMessage(int messageId,
@@ -73,25 +103,7 @@ void SocketClient::showOrUpdateMessage(int messageId,
         spdlog::warn("Invalid message id");
         return;
     }
-    if (_messageMap.contains(messageId)) {
-        _messageMap.erase(messageId);
-    }
-    _messageMap[messageId] = message;
-    evento::executor()->asyncExecute(
-        [messageId, this]() -> net::awaitable<void> {
-            // A factory function to create awaitable task when the timer is triggered
-            if (_messageMap.contains(messageId)) {
-                auto message = std::move(_messageMap[messageId]);
-                _messageMap.erase(messageId);
-                return this->send(std::move(message));
-            } else {
-                // do nothing
-                return []() -> net::awaitable<void> { co_return; }();
-            }
-        },
-        []() {},
-        time - std::chrono::system_clock::now(),
-        AsyncExecutor::Delay | AsyncExecutor::Once);
+    _notifications->schedule(messageId, message, time);
 }
 
 void SocketClient::cancelMessage(int messageId) {
@@ -99,67 +111,280 @@ void SocketClient::cancelMessage(int messageId) {
         spdlog::warn("Invalid message id");
         return;
     }
-    if (_messageMap.contains(messageId)) {
-        _messageMap.erase(messageId);
-    }
+    _notifications->cancel(messageId);
 }
 
 void SocketClient::deleteAllMessage() {
-    _messageMap.clear();
+    _notifications->cancelAll();
 }
 
-net::awaitable<void> SocketClient::connect(std::uint16_t port) {
-    _socket = std::make_unique<net::ip::tcp::socket>(co_await net::this_coro::executor);
-    net::ip::tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"), port);
+net::awaitable<bool> SocketClient::ensureTray() {
+    if (_closing) {
+        co_return false;
+    }
+    auto running = _running;
+    if (_trayState == TrayState::Stopped) {
+        _trayState = TrayState::Starting;
+        _trayReady = std::make_unique<net::steady_timer>(co_await net::this_coro::executor,
+                                                         net::steady_timer::time_point::max());
+        net::co_spawn(co_await net::this_coro::executor, runTray(), net::detached);
+    }
+    if (_trayState == TrayState::Starting) {
+        co_await _trayReady->async_wait(net::as_tuple(net::use_awaitable));
+    }
+    co_return _trayState == TrayState::Connected;
+}
 
-    co_await _socket->async_connect(endpoint, net::use_awaitable);
+net::awaitable<void> SocketClient::runTray() {
+    auto running = _running;
+    auto start = std::chrono::steady_clock::now();
+    bool connected = false;
+    if (auto endpoint = co_await spawnTray()) {
+        connected = co_await connect(*endpoint);
+    }
+    // `stopTray()` or `shutdown()` may have run meanwhile
+    if (_trayState == TrayState::Starting && !_closing) {
+        _trayState = connected ? TrayState::Connected : TrayState::Failed;
+    }
+    connected = connected && _trayState == TrayState::Connected;
+    _connected = connected;
+    _trayReady->cancel();
+    if (!connected) {
+        std::error_code ec;
+        _tray.terminate(ec);
+        close();
+        co_return;
+    }
+    spdlog::info("Tray connected in {}ms",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count());
 
-    for (;;) {
-        net::co_spawn(_socket->get_executor(), handleReceive(co_await receive()), net::detached);
+    // until the tray exits or the connection is closed
+    tray::FrameReader reader;
+    while (co_await receive(reader)) {
+    }
+    _connected = false;
+    if (_trayState == TrayState::Connected) {
+        // started again on demand
+        _trayState = TrayState::Stopped;
     }
+    close();
 }
 
-net::awaitable<std::string> SocketClient::receive() {
-    if (!_socket) {
-        spdlog::error("Socket is not connected");
-        co_return "";
+net::awaitable<std::optional<std::string>> SocketClient::spawnTray() {
+    using namespace net::experimental::awaitable_operators;
+
+    boost::filesystem::path trayPath = boost::dll::program_location().parent_path();
+#ifdef EVENTO_DEBUG
+    trayPath /= "../Tray/Debug";
+#endif
+#ifdef PLATFORM_WINDOWS
+    trayPath /= "sast-evento-tray.exe";
+#else
+    trayPath /= "sast-evento-tray";
+#endif
+
+    auto& ioc = executor()->getIoContext();
+    bp::async_pipe pipe(ioc);
+    auto exited = std::make_shared<net::steady_timer>(ioc, net::steady_timer::time_point::max());
+    std::error_code ec;
+    bp::child tray(trayPath,
+                   bp::std_in.close(),
+                   bp::std_out > pipe,
+                   bp::std_err > bp::null,
+                   ioc,
+                   bp::on_exit([exited](int, std::error_code const&) {
+                       // a wait started after this completes right away
+                       exited->expires_at(net::steady_timer::time_point::min());
+                   }),
+                   ec);
+    if (ec) {
+        spdlog::error("Failed to start tray: file = {}, reason = {}",
+                      trayPath.string(),
+                      ec.message());
+        co_return std::nullopt;
     }
+    _tray = std::move(tray);
+    _trayExited = std::move(exited);
 
-    std::string data;
-    data.resize(1024);
-    auto size = co_await _socket->async_receive(net::buffer(data), 0, net::use_awaitable);
-    data.resize(size);
-    co_return data;
+    // the tray prints where it listens once it does
+    std::string line;
+    net::steady_timer timeout(co_await net::this_coro::executor, TRAY_TIMEOUT);
+    auto result = co_await (net::async_read_until(pipe,
+                                                  net::dynamic_buffer(line),
+                                                  '\n',
+                                                  net::as_tuple(net::use_awaitable))
+                            || timeout.async_wait(net::as_tuple(net::use_awaitable)));
+    std::string endpoint;
+    if (result.index() == 0) {
+        auto [readEc, _] = std::get<0>(result);
+        if (!readEc) {
+            endpoint = line.substr(0, line.find_first_of("\r\n"));
+        }
+    }
+    if (endpoint.empty()) {
+        spdlog::error("Failed to start tray: file = {}, reason = {}",
+                      trayPath.string(),
+                      "no endpoint");
+        co_return std::nullopt;
+    }
+    spdlog::info("Tray started at: {}", endpoint);
+    co_return endpoint;
 }
 
-net::awaitable<void> SocketClient::send(std::string message) {
+net::awaitable<bool> SocketClient::connect(std::string const& endpoint) {
+#ifdef PLATFORM_WINDOWS
+    // the pipe exists once the tray printed its name, opening it does not block
+    auto handle = CreateFileA(endpoint.c_str(),
+                              GENERIC_READ | GENERIC_WRITE,
+                              0,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_FLAG_OVERLAPPED,
+                              nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        spdlog::error("Failed to connect to tray at {}: error {}", endpoint, GetLastError());
+        co_return false;
+    }
+    _socket = std::make_unique<Stream>(co_await net::this_coro::executor, handle);
+    co_return true;
+#else
+    using namespace net::experimental::awaitable_operators;
+
+    _socket = std::make_unique<Stream>(co_await net::this_coro::executor);
+    net::steady_timer timeout(co_await net::this_coro::executor, TRAY_TIMEOUT);
+    auto result = co_await (
+        _socket->async_connect(net::local::stream_protocol::endpoint(endpoint),
+                               net::as_tuple(net::use_awaitable))
+        || timeout.async_wait(net::as_tuple(net::use_awaitable)));
+    if (result.index() == 1 || std::get<0>(std::get<0>(result))) {
+        spdlog::error("Failed to connect to tray at {}", endpoint);
+        co_return false;
+    }
+    co_return true;
+#endif
+}
+
+net::awaitable<void> SocketClient::stopTray() {
+    using namespace net::experimental::awaitable_operators;
+
+    std::error_code ec;
+    auto wasConnected = _trayState == TrayState::Connected;
+    // no restart on demand from now on
+    _trayState = TrayState::Failed;
+    if (wasConnected) {
+        // notifications still queued are moot once the app exits
+        _queued.clear();
+        tray::appendFrame(_queued, MessageType::Exit);
+        spdlog::info("IPC Send: Exit");
+        // a write in flight or posted picks the frame up
+        if (!_writing) {
+            co_await writeQueued();
+        }
+        // the io thread keeps serving the others meanwhile
+        net::steady_timer timeout(co_await net::this_coro::executor, TRAY_TIMEOUT);
+        auto exited = _trayExited;
+        auto result = co_await (exited->async_wait(net::as_tuple(net::use_awaitable))
+                                || timeout.async_wait(net::as_tuple(net::use_awaitable)));
+        if (result.index() == 1) {
+            _tray.terminate(ec);
+        }
+    } else if (_tray.valid()) {
+        _tray.terminate(ec);
+    } else {
+        co_return;
+    }
+    spdlog::info("Tray exited with code: {}", _tray.exit_code());
+}
+
+net::awaitable<bool> SocketClient::receive(tray::FrameReader& reader) {
     if (!_socket) {
-        spdlog::error("Socket is not connected");
+        co_return false;
+    }
+
+    char data[1024];
+    auto [ec, size] = co_await _socket->async_read_some(net::buffer(data),
+                                                        net::as_tuple(net::use_awaitable));
+    if (ec) {
+        co_return false;
+    }
+    reader.append(data, size);
+    while (auto frame = reader.next()) {
+        handleReceive(*frame);
+    }
+    if (reader.failed()) {
+        spdlog::error("IPC Received an oversized frame, disconnecting");
+        co_return false;
+    }
+    co_return true;
+}
+
+net::awaitable<void> SocketClient::send(MessageType type, std::string payload) {
+    if (_closing) {
         co_return;
     }
+    auto running = _running;
+    if (!co_await ensureTray()) {
+        spdlog::warn("Tray is not available, message dropped: {}", payload);
+        co_return;
+    }
+    if (_queued.size() + tray::HEADER_SIZE + payload.size() > MAX_QUEUED_BYTES) {
+        // the tray does not keep up, e.g. it hangs, notifications are not worth blocking for
+        spdlog::warn("IPC queue is full, message dropped: {}", payload);
+        co_return;
+    }
+
+    spdlog::info("IPC Send: {}", payload);
+    tray::appendFrame(_queued, type, payload);
+    if (!_writing) {
+        // posted, so that frames queued in the same turn of the io loop join the batch,
+        // `shutdown()` waits for it from now on
+        net::co_spawn(
+            co_await net::this_coro::executor,
+            [this, running]() -> net::awaitable<void> { co_await writeQueued(); },
+            net::detached);
+        _writing = true;
+    }
+}
 
-    spdlog::info("IPC Send: {}", message);
-    co_await net::async_write(*_socket, net::buffer(message), net::use_awaitable);
+net::awaitable<void> SocketClient::writeQueued() {
+    _writing = true;
+    std::string batch;
+    while (_socket && !_queued.empty()) {
+        batch.clear();
+        std::swap(batch, _queued);
+        auto [ec, _] = co_await net::async_write(*_socket,
+                                                 net::buffer(batch),
+                                                 net::as_tuple(net::use_awaitable));
+        if (ec) {
+            spdlog::warn("IPC Send failed: {}", ec.message());
+            _queued.clear();
+            break;
+        }
+    }
+    _writing = false;
 }
 
 void SocketClient::close() {
     if (_socket) {
         boost::system::error_code ec;
+#ifndef PLATFORM_WINDOWS
         ec = _socket->shutdown(net::socket_base::shutdown_both, ec);
+#endif
         ec = _socket->close(ec);
         _socket.reset();
     }
 }
 
-net::awaitable<void> SocketClient::handleReceive(std::string const& message) {
-    spdlog::info("IPC Received: {}", message);
-    auto action = _actions.find(message);
+void SocketClient::handleReceive(tray::Frame const& frame) {
+    spdlog::info("IPC Received: {}", static_cast<int>(frame.type));
+    auto action = _actions.find(frame.type);
     if (action != _actions.end()) {
         slint::invoke_from_event_loop(action->second);
     } else {
-        spdlog::warn("Unknown message: {}", message);
+        spdlog::warn("Unknown message: {}", static_cast<int>(frame.type));
     }
-    co_return;
 }
 
 SocketClient* ipc() {
@@ -1,25 +1,49 @@
 #pragma once
 
+#include <Infrastructure/IPC/NotificationScheduler.h>
+#include <Infrastructure/IPC/TrayProtocol.h>
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/io_context.hpp>
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/process.hpp>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#ifdef PLATFORM_WINDOWS
+#include <boost/asio/windows/stream_handle.hpp>
+#else
+#include <boost/asio/local/stream_protocol.hpp>
+#endif
 
 namespace evento {
 
 namespace net = boost::asio;
 
+// Talks to `sast-evento-tray` over a Unix domain socket, a named pipe on Windows, in frames
+// of `TrayProtocol.h`. Everything but the public members runs in the io thread, the
+// destructor waits for it to end there.
 class SocketClient {
 public:
-    SocketClient(std::unordered_map<std::string_view, std::function<void()>> actions);
+    using MessageType = tray::MessageType;
+
+    SocketClient(std::unordered_map<MessageType, std::function<void()>> actions);
     ~SocketClient();
 
+    // Spawns `sast-evento-tray` and connects to it in the io thread, returns immediately.
+    // No-op while the tray is starting or up, and after it failed to start.
+    // Messages start it on demand, the app once the window is drawn if minimal-to-tray is on.
     void startTray();
+    // whether the tray is up, i.e. whether a hidden window can be shown again, thread-safe
+    [[nodiscard]] bool trayConnected() const { return _connected; }
+    // Asks the tray to exit and waits for it, terminates it from the calling thread if the
+    // io thread is gone, e.g. stopped by a signal, or does not get it done in time.
     void exitTray();
 
+    // see `NotificationScheduler`, delivered through the tray, which is started if needed
     void showOrUpdateMessage(int messageId,
                              std::string const& message,
                              std::chrono::system_clock::time_point const& time);
@@ -27,28 +51,68 @@ public:
     void cancelMessage(int messageId);
     void deleteAllMessage();
 
-    struct MessageType {
-        static constexpr std::string_view ShowWindow = "SHOW";
-        static constexpr std::string_view ShowAboutPage = "ABOUT";
-        static constexpr std::string_view ExitApp = "EXIT";
-    };
-
     inline static SocketClient* _instance = nullptr;
 
+    // for the endpoint line of the tray and for the connection to it, each
+    static constexpr auto TRAY_TIMEOUT = std::chrono::seconds(5);
+    // frames queued while a write is in flight, notifications beyond this are dropped
+    static constexpr std::size_t MAX_QUEUED_BYTES = 256 * 1024;
+
 private:
-    boost::process::child _tray;
+    enum class TrayState {
+        Stopped,
+        Starting,
+        Connected,
+        Failed, // not retried
+    };
 
-    net::awaitable<void> handleReceive(std::string const& message);
+#ifdef PLATFORM_WINDOWS
+    using Stream = net::windows::stream_handle;
+#else
+    using Stream = net::local::stream_protocol::socket;
+#endif
 
-    net::awaitable<void> connect(std::uint16_t port);
-    net::awaitable<void> send(std::string message);
-    net::awaitable<std::string> receive();
+    boost::process::child _tray;
+    // io thread only
+    TrayState _trayState = TrayState::Stopped;
+    // expires when a start attempt is over, see `ensureTray()`
+    std::unique_ptr<net::steady_timer> _trayReady;
+    // expires once the tray process exits, shared with its exit handler
+    std::shared_ptr<net::steady_timer> _trayExited;
+    std::atomic<bool> _connected = false;
+
+    void handleReceive(tray::Frame const& frame);
+
+    // closes the socket and waits for the coroutines using it, in the io thread
+    net::awaitable<void> shutdown();
+
+    // starts the tray if needed, `true` once it is connected
+    net::awaitable<bool> ensureTray();
+    net::awaitable<void> runTray();
+    // spawns the tray and reads the socket path or pipe name it listens on
+    net::awaitable<std::optional<std::string>> spawnTray();
+    net::awaitable<bool> connect(std::string const& endpoint);
+    // asks the tray to exit, terminates it if it does not
+    net::awaitable<void> stopTray();
+    // queues a frame, written with the others queued meanwhile by `writeQueued()`
+    net::awaitable<void> send(MessageType type, std::string payload = {});
+    net::awaitable<void> writeQueued();
+    // handles the frames of one read, `false` once the connection is gone or broken
+    net::awaitable<bool> receive(tray::FrameReader& reader);
     void close();
 
-    std::unique_ptr<net::ip::tcp::socket> _socket;
-    std::unordered_map<std::string_view, std::function<void()>> _actions;
-
-    std::unordered_map<int, std::string> _messageMap;
+    std::unique_ptr<Stream> _socket;
+    std::unordered_map<MessageType, std::function<void()>> _actions;
+    std::string _queued; // encoded frames
+    bool _writing = false;
+    // io thread only, nothing new starts once set
+    bool _closing = false;
+    // held by every coroutine running on `this`, reset by `shutdown()`, the last one to let
+    // go expires `_stopped`
+    std::shared_ptr<void> _running;
+    std::shared_ptr<net::steady_timer> _stopped;
+
+    std::shared_ptr<NotificationScheduler> _notifications;
 };
 
 SocketClient* ipc();
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Messages between the app and `sast-evento-tray`, shared by both, C++17 for the Qt tray.
+//
+// A frame is the payload size as u32 little-endian, the type as u8, then the payload.
+// A read may hold several frames, e.g. a batch of notifications, or a part of one,
+// so the receiving side feeds whatever it read into a `FrameReader`.
+
+namespace evento::tray {
+
+enum class MessageType : std::uint8_t {
+    // tray -> app
+    ShowWindow = 1,
+    ShowAboutPage = 2,
+    ExitApp = 3,
+    // app -> tray
+    Notify = 16, // UTF-8 text of the notification
+    Exit = 17,
+};
+
+constexpr std::size_t HEADER_SIZE = 5;
+// a larger frame is a protocol error, the connection is dropped
+constexpr std::size_t MAX_PAYLOAD = 64 * 1024;
+
+struct Frame {
+    MessageType type;
+    std::string payload;
+};
+
+inline void appendFrame(std::string& out, MessageType type, std::string_view payload = {}) {
+    auto size = static_cast<std::uint32_t>(payload.size());
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+    }
+    out.push_back(static_cast<char>(type));
+    out.append(payload);
+}
+
+class FrameReader {
+public:
+    void append(const char* data, std::size_t size) { _buffer.append(data, size); }
+
+    // the next complete frame, `std::nullopt` if more data is needed or on error
+    std::optional<Frame> next() {
+        if (_failed || _buffer.size() - _offset < HEADER_SIZE) {
+            return std::nullopt;
+        }
+        auto header = reinterpret_cast<const unsigned char*>(_buffer.data() + _offset);
+        std::uint32_t size = 0;
+        for (int i = 0; i < 4; ++i) {
+            size |= static_cast<std::uint32_t>(header[i]) << (8 * i);
+        }
+        if (size > MAX_PAYLOAD) {
+            _failed = true;
+            return std::nullopt;
+        }
+        if (_buffer.size() - _offset < HEADER_SIZE + size) {
+            return std::nullopt;
+        }
+        Frame frame{static_cast<MessageType>(header[4]),
+                    _buffer.substr(_offset + HEADER_SIZE, size)};
+        _offset += HEADER_SIZE + size;
+        // drop consumed frames once nothing is left, or once they dominate the buffer
+        if (_offset == _buffer.size() || _offset > MAX_PAYLOAD) {
+            _buffer.erase(0, _offset);
+            _offset = 0;
+        }
+        return frame;
+    }
+
+    // an oversized frame was announced, nothing more can be read
+    [[nodiscard]] bool failed() const { return _failed; }
+
+private:
+    std::string _buffer;
+    std::size_t _offset = 0;
+    bool _failed = false;
+};
+
+} // namespace evento::tray
@@ -32,7 +32,7 @@ struct Evento {
                                                          url.encoded_query().data()),
                                              11};
 
-        req.set(http::field::host, url.host());
+        req.set(http::field::host, url.encoded_host_and_port());
         req.set(http::field::user_agent, "SAST-Evento-Desktop/2");
         if (token) // set token if exists
             req.set("TOKEN", *token);
@@ -28,7 +28,7 @@ struct Github {
                                                          url.query()),
                                              11};
 
-        req.set(http::field::host, url.host_name());
+        req.set(http::field::host, url.encoded_host_and_port());
         req.set(http::field::user_agent, "SAST-Evento-Desktop/2");
         req.set(http::field::accept, MIME_GITHUB_JSON);
         req.set("X-GitHub-Api-Version", "2022-11-28");
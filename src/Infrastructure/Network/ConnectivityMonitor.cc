@@ -0,0 +1,163 @@
+#include <Infrastructure/Network/ConnectivityMonitor.h>
+#include <algorithm>
+#include <array>
+#include <spdlog/spdlog.h>
+
+#ifdef PLATFORM_LINUX
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace evento {
+
+bool ConnectivityMonitor::offline() {
+    if (!_linkUp) {
+        return true;
+    }
+    if (!_inferredOffline) {
+        return false;
+    }
+    // let a single probe through once in a while, another one only if it never came back
+    auto now = std::chrono::steady_clock::now();
+    if (now - std::max(_lastFailure, _lastProbe) < PROBE_INTERVAL) {
+        return true;
+    }
+    _lastProbe = now;
+    return false;
+}
+
+void ConnectivityMonitor::recordSuccess() {
+    _failures = 0;
+    if (_inferredOffline) {
+        spdlog::info("Network is reachable again");
+        _inferredOffline = false;
+    }
+    // a response proves a usable link, whatever the OS said
+    _linkUp = true;
+    notify();
+}
+
+void ConnectivityMonitor::recordFailure() {
+    _lastFailure = std::chrono::steady_clock::now();
+    if (++_failures >= FAILURE_THRESHOLD && !_inferredOffline) {
+        spdlog::warn("{} consecutive connection failures, assuming offline", _failures);
+        _inferredOffline = true;
+    }
+    notify();
+}
+
+void ConnectivityMonitor::setLinkUp(bool linkUp) {
+    if (linkUp == _linkUp) {
+        return;
+    }
+    spdlog::info("Network interfaces are {}", linkUp ? "up" : "down");
+    _linkUp = linkUp;
+    if (linkUp) {
+        // give requests a chance right away instead of waiting for the next probe
+        _inferredOffline = false;
+        _failures = 0;
+    }
+    notify();
+}
+
+void ConnectivityMonitor::notify() {
+    bool online = _linkUp && !_inferredOffline;
+    if (online == _reportedOnline) {
+        return;
+    }
+    _reportedOnline = online;
+    if (_listener) {
+        _listener(online);
+    }
+}
+
+#ifdef PLATFORM_LINUX
+
+bool ConnectivityMonitor::hasUsableInterface() {
+    ifaddrs* addresses = nullptr;
+    if (::getifaddrs(&addresses) != 0) {
+        // cannot tell, do not block requests
+        return true;
+    }
+    bool usable = false;
+    for (auto it = addresses; it && !usable; it = it->ifa_next) {
+        if (!it->ifa_addr || !(it->ifa_flags & IFF_UP) || !(it->ifa_flags & IFF_RUNNING)
+            || (it->ifa_flags & IFF_LOOPBACK)) {
+            continue;
+        }
+        if (it->ifa_addr->sa_family == AF_INET) {
+            auto address = ntohl(reinterpret_cast<sockaddr_in*>(it->ifa_addr)->sin_addr.s_addr);
+            // skip 169.254.0.0/16, assigned when DHCP failed
+            usable = (address >> 16) != 0xa9fe;
+        } else if (it->ifa_addr->sa_family == AF_INET6) {
+            auto const& address = reinterpret_cast<sockaddr_in6*>(it->ifa_addr)->sin6_addr;
+            usable = !IN6_IS_ADDR_LINKLOCAL(&address);
+        }
+    }
+    ::freeifaddrs(addresses);
+    return usable;
+}
+
+Task<void> ConnectivityMonitor::watch(Listener listener) {
+    _listener = std::move(listener);
+    setLinkUp(hasUsableInterface());
+
+    int fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) {
+        spdlog::warn("Failed to open netlink socket, connectivity is inferred from requests");
+        co_return;
+    }
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE
+                        | RTMGRP_IPV6_ROUTE;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        spdlog::warn("Failed to bind netlink socket, connectivity is inferred from requests");
+        co_return;
+    }
+
+    auto executor = co_await net::this_coro::executor;
+    net::posix::stream_descriptor descriptor(executor, fd);
+    net::steady_timer settle(executor);
+    std::array<char, 8192> buffer;
+    while (true) {
+        auto [ec] = co_await descriptor.async_wait(net::posix::descriptor_base::wait_read,
+                                                   net::as_tuple(net::use_awaitable));
+        if (ec) {
+            spdlog::debug("Stop watching netlink: {}", ec.message());
+            co_return;
+        }
+        // the messages themselves do not matter, the state is re-read below
+        while (::recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT) > 0) {
+        }
+        // a reconnect comes as a burst of events, wait for it to settle
+        settle.expires_after(std::chrono::milliseconds(500));
+        co_await settle.async_wait(net::as_tuple(net::use_awaitable));
+        while (::recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT) > 0) {
+        }
+        setLinkUp(hasUsableInterface());
+    }
+}
+
+#else
+
+bool ConnectivityMonitor::hasUsableInterface() {
+    return true;
+}
+
+Task<void> ConnectivityMonitor::watch(Listener listener) {
+    // no OS notifications wired up here, rely on request outcomes
+    _listener = std::move(listener);
+    co_return;
+}
+
+#endif
+
+} // namespace evento
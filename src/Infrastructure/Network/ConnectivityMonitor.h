@@ -0,0 +1,54 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <functional>
+
+namespace evento {
+
+namespace net = boost::asio; // from <boost/asio.hpp>
+
+template<typename T>
+using Task = net::awaitable<T>;
+
+// Tells whether the network is worth trying at all.
+// Two sources feed it:
+// - the OS: on Linux, netlink link/address/route events re-check for a usable interface
+// - request outcomes: `FAILURE_THRESHOLD` consecutive connection failures mean offline,
+//   then one request per `PROBE_INTERVAL` is let through to find out if we are back,
+//   rejections of a host known to be down (`Error::Unavailable`) say nothing about the network
+//
+// All members must be called in the io thread.
+class ConnectivityMonitor {
+public:
+    using Listener = std::function<void(bool online)>;
+
+    // whether a request must not be sent now, false for the one caller that gets to probe
+    [[nodiscard]] bool offline();
+
+    void recordSuccess();
+    void recordFailure();
+
+    // watch OS network changes until the io context stops,
+    // `listener` is called in the io thread on every transition
+    Task<void> watch(Listener listener);
+
+    static constexpr int FAILURE_THRESHOLD = 3;
+    static constexpr std::chrono::seconds PROBE_INTERVAL{10};
+
+private:
+    // whether any interface other than loopback is up and has a routable address
+    static bool hasUsableInterface();
+    void setLinkUp(bool linkUp);
+    void notify();
+
+    bool _linkUp = true;
+    bool _inferredOffline = false;
+    int _failures = 0;
+    std::chrono::steady_clock::time_point _lastFailure;
+    std::chrono::steady_clock::time_point _lastProbe;
+    bool _reportedOnline = true;
+    Listener _listener;
+};
+
+} // namespace evento
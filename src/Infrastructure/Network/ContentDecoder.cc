@@ -0,0 +1,168 @@
+#include <Infrastructure/Network/ContentDecoder.h>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <string>
+#include <zlib.h>
+
+#ifdef EVENTO_HAS_BROTLI
+#include <brotli/decode.h>
+#endif
+
+namespace evento {
+
+struct ContentDecoder::Impl {
+    const char* input = nullptr;
+    std::size_t inputSize = 0;
+    z_stream zstream{};
+    bool zstreamReady = false;
+    bool done = false;
+    // the last read filled `output`, more may be pending without further input
+    bool outputFull = false;
+#ifdef EVENTO_HAS_BROTLI
+    BrotliDecoderState* brotli = nullptr;
+#endif
+    std::array<char, OUTPUT_CHUNK_SIZE> output;
+};
+
+std::optional<ContentDecoder::Encoding> ContentDecoder::parse(std::string_view contentEncoding) {
+    std::string value(contentEncoding);
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+        return std::tolower(c);
+    });
+    // stacked encodings are not used by any server we talk to
+    if (value.empty() || value == "identity") {
+        return Encoding::Identity;
+    }
+    if (value == "gzip" || value == "x-gzip") {
+        return Encoding::Gzip;
+    }
+    if (value == "deflate") {
+        return Encoding::Deflate;
+    }
+#ifdef EVENTO_HAS_BROTLI
+    if (value == "br") {
+        return Encoding::Brotli;
+    }
+#endif
+    return std::nullopt;
+}
+
+ContentDecoder::ContentDecoder(Encoding encoding)
+    : _encoding(encoding)
+    , _impl(std::make_unique<Impl>()) {
+    if (encoding == Encoding::Gzip) {
+        _impl->zstreamReady = inflateInit2(&_impl->zstream, 16 + MAX_WBITS) == Z_OK;
+    }
+#ifdef EVENTO_HAS_BROTLI
+    if (encoding == Encoding::Brotli) {
+        _impl->brotli = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+    }
+#endif
+}
+
+ContentDecoder::~ContentDecoder() {
+    if (_impl->zstreamReady) {
+        inflateEnd(&_impl->zstream);
+    }
+#ifdef EVENTO_HAS_BROTLI
+    if (_impl->brotli) {
+        BrotliDecoderDestroyInstance(_impl->brotli);
+    }
+#endif
+}
+
+void ContentDecoder::feed(const char* data, std::size_t size) {
+    _encodedSize += size;
+    _impl->input = data;
+    _impl->inputSize = size;
+}
+
+Result<std::string_view> ContentDecoder::read() {
+    auto& impl = *_impl;
+
+    if (_encoding == Encoding::Identity) {
+        std::string_view piece(impl.input, impl.inputSize);
+        impl.inputSize = 0;
+        _decodedSize += piece.size();
+        return Ok(piece);
+    }
+
+    if (impl.done || (impl.inputSize == 0 && !impl.outputFull)) {
+        return Ok(std::string_view{});
+    }
+
+#ifdef EVENTO_HAS_BROTLI
+    if (_encoding == Encoding::Brotli) {
+        if (!impl.brotli) {
+            return Err(Error(Error::Data, "brotli decoder unavailable"));
+        }
+        auto next = reinterpret_cast<const std::uint8_t*>(impl.input);
+        auto available = impl.inputSize;
+        auto out = reinterpret_cast<std::uint8_t*>(impl.output.data());
+        auto outAvailable = impl.output.size();
+        auto state = BrotliDecoderDecompressStream(impl.brotli,
+                                                   &available,
+                                                   &next,
+                                                   &outAvailable,
+                                                   &out,
+                                                   nullptr);
+        if (state == BROTLI_DECODER_RESULT_ERROR) {
+            return Err(Error(Error::Data,
+                             BrotliDecoderErrorString(BrotliDecoderGetErrorCode(impl.brotli))));
+        }
+        impl.input = reinterpret_cast<const char*>(next);
+        impl.inputSize = available;
+        impl.done = state == BROTLI_DECODER_RESULT_SUCCESS;
+        impl.outputFull = outAvailable == 0;
+        std::string_view piece(impl.output.data(), impl.output.size() - outAvailable);
+        _decodedSize += piece.size();
+        return Ok(piece);
+    }
+#endif
+
+    if (!impl.zstreamReady) {
+        if (_encoding != Encoding::Deflate) {
+            return Err(Error(Error::Data, "zlib initialization failed"));
+        }
+        if (impl.inputSize == 0) {
+            return Ok(std::string_view{});
+        }
+        // "deflate" is meant to be zlib-wrapped, but some servers send raw deflate
+        auto cmf = static_cast<unsigned char>(impl.input[0]);
+        bool wrapped = (cmf & 0x0f) == Z_DEFLATED
+                       && (impl.inputSize < 2
+                           || ((cmf << 8) | static_cast<unsigned char>(impl.input[1])) % 31
+                                  == 0);
+        if (inflateInit2(&impl.zstream, wrapped ? MAX_WBITS : -MAX_WBITS) != Z_OK) {
+            return Err(Error(Error::Data, "zlib initialization failed"));
+        }
+        impl.zstreamReady = true;
+    }
+
+    impl.zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(impl.input));
+    impl.zstream.avail_in = static_cast<uInt>(impl.inputSize);
+    impl.zstream.next_out = reinterpret_cast<Bytef*>(impl.output.data());
+    impl.zstream.avail_out = static_cast<uInt>(impl.output.size());
+    auto ret = inflate(&impl.zstream, Z_NO_FLUSH);
+    if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+        return Err(
+            Error(Error::Data, impl.zstream.msg ? impl.zstream.msg : "corrupted compressed body"));
+    }
+    impl.input = reinterpret_cast<const char*>(impl.zstream.next_in);
+    impl.inputSize = impl.zstream.avail_in;
+    impl.done = ret == Z_STREAM_END;
+    impl.outputFull = impl.zstream.avail_out == 0;
+    std::string_view piece(impl.output.data(), impl.output.size() - impl.zstream.avail_out);
+    _decodedSize += piece.size();
+    return Ok(piece);
+}
+
+Result<void> ContentDecoder::finish() {
+    if (_encoding == Encoding::Identity || _impl->done) {
+        return Ok();
+    }
+    return Err(Error(Error::Data, "truncated compressed body"));
+}
+
+} // namespace evento
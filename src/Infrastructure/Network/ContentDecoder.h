@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Infrastructure/Utils/Result.h>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace evento {
+
+// Incremental decoder of a `Content-Encoding`d body.
+// Input is fed chunk by chunk and decoded output is pulled through a fixed buffer,
+// so memory stays bounded whatever the size of the body:
+//
+//     decoder.feed(data, size);
+//     while (!(piece = decoder.read()).unwrap().empty()) { ... }
+class ContentDecoder {
+public:
+    enum class Encoding {
+        Identity,
+        Gzip,
+        Deflate,
+#ifdef EVENTO_HAS_BROTLI
+        Brotli,
+#endif
+    };
+
+    // value for the `Accept-Encoding` request header
+#ifdef EVENTO_HAS_BROTLI
+    static constexpr const char ACCEPT_ENCODING[] = "gzip, deflate, br";
+#else
+    static constexpr const char ACCEPT_ENCODING[] = "gzip, deflate";
+#endif
+
+    static constexpr std::size_t OUTPUT_CHUNK_SIZE = 64 * 1024;
+
+    // `std::nullopt` if `contentEncoding` is not supported
+    static std::optional<Encoding> parse(std::string_view contentEncoding);
+
+    explicit ContentDecoder(Encoding encoding);
+    ContentDecoder(const ContentDecoder&) = delete;
+    ContentDecoder& operator=(const ContentDecoder&) = delete;
+    ~ContentDecoder();
+
+    // `data` must stay alive until `read()` returns an empty piece
+    void feed(const char* data, std::size_t size);
+    // next piece of decoded output, valid until the next call,
+    // empty once everything fed so far has been decoded
+    Result<std::string_view> read();
+    // fails if the encoded stream was cut short
+    Result<void> finish();
+
+    [[nodiscard]] std::size_t encodedSize() const { return _encodedSize; }
+    [[nodiscard]] std::size_t decodedSize() const { return _decodedSize; }
+
+private:
+    struct Impl;
+
+    Encoding _encoding;
+    std::unique_ptr<Impl> _impl;
+    std::size_t _encodedSize = 0;
+    std::size_t _decodedSize = 0;
+};
+
+} // namespace evento
@@ -0,0 +1,159 @@
+#include <Infrastructure/Network/DownloadManager.h>
+#include <algorithm>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/url.hpp>
+#include <spdlog/spdlog.h>
+
+namespace evento {
+
+namespace urls = boost::urls; // from <boost/url.hpp>
+
+DownloadManager::DownloadManager(std::size_t maxConcurrent, std::size_t maxPerHost)
+    : _maxConcurrent(std::max<std::size_t>(maxConcurrent, 1))
+    , _maxPerHost(std::max<std::size_t>(maxPerHost, 1)) {}
+
+Task<Result<std::filesystem::path>> DownloadManager::download(std::string url,
+                                                              DownloadPriority priority,
+                                                              DownloadProgress progress,
+                                                              Fetcher fetch) {
+    using namespace net::experimental::awaitable_operators;
+    // the same url is already queued or downloading, just wait for it
+    if (auto it = _jobs.find(url); it != _jobs.end()) {
+        auto job = it->second;
+        spdlog::debug("Download merged: {}", url);
+        if (progress) {
+            job->progress.push_back(std::move(progress));
+        }
+        if (!job->started && priority < job->priority) {
+            job->priority = priority;
+            _queue.remove(job);
+            enqueue(job);
+            dispatch();
+        }
+        if (!job->result) {
+            co_await job->doneSignal.async_wait(net::as_tuple(net::use_awaitable));
+        }
+        co_return *job->result;
+    }
+
+    auto job = std::make_shared<Job>(co_await net::this_coro::executor);
+    job->url = url;
+    if (auto parsed = urls::parse_uri(url)) {
+        job->host = std::string(parsed->encoded_host_and_port());
+    }
+    job->priority = priority;
+    job->sequence = _nextSequence++;
+    if (progress) {
+        job->progress.push_back(std::move(progress));
+    }
+    _jobs.emplace(url, job);
+    enqueue(job);
+    dispatch();
+
+    if (!job->started && !job->result) {
+        co_await job->startSignal.async_wait(net::as_tuple(net::use_awaitable));
+    }
+    if (job->result) {
+        // cancelled while queued, or right after it was started
+        if (job->started) {
+            release(job);
+        }
+        co_return *job->result;
+    }
+
+    auto cancelled = [job]() -> Task<void> {
+        co_await job->cancelSignal.async_wait(net::as_tuple(net::use_awaitable));
+    };
+    auto outcome = co_await (
+        fetch(url,
+              [job](std::size_t received, std::optional<std::size_t> total) {
+                  for (auto const& callback : job->progress) {
+                      callback(received, total);
+                  }
+              })
+        || cancelled());
+
+    release(job);
+    // a cancelled job has already released its waiters, its transfer is aborted
+    if (outcome.index() == 0 && !job->result) {
+        finish(job, std::get<0>(std::move(outcome)));
+    }
+
+    co_return *job->result;
+}
+
+void DownloadManager::cancel(std::string const& url) {
+    cancelJobs([&url](Job const& job) { return job.url == url; });
+}
+
+void DownloadManager::cancel(DownloadPriority priority) {
+    cancelJobs([priority](Job const& job) { return job.priority >= priority; });
+}
+
+bool DownloadManager::canStart(std::string const& host) const {
+    if (_running >= _maxConcurrent) {
+        return false;
+    }
+    auto it = _runningPerHost.find(host);
+    return it == _runningPerHost.end() || it->second < _maxPerHost;
+}
+
+void DownloadManager::enqueue(JobPtr const& job) {
+    auto pos = std::find_if(_queue.begin(), _queue.end(), [&job](JobPtr const& queued) {
+        return queued->priority > job->priority
+               || (queued->priority == job->priority && queued->sequence > job->sequence);
+    });
+    _queue.insert(pos, job);
+}
+
+void DownloadManager::dispatch() {
+    for (auto it = _queue.begin(); it != _queue.end() && _running < _maxConcurrent;) {
+        auto job = *it;
+        if (!canStart(job->host)) {
+            ++it;
+            continue;
+        }
+        it = _queue.erase(it);
+        job->started = true;
+        ++_running;
+        ++_runningPerHost[job->host];
+        job->startSignal.cancel();
+    }
+}
+
+void DownloadManager::finish(JobPtr const& job, Result<std::filesystem::path> result) {
+    job->result = std::move(result);
+    if (auto it = _jobs.find(job->url); it != _jobs.end() && it->second == job) {
+        _jobs.erase(it);
+    }
+    job->startSignal.cancel();
+    job->doneSignal.cancel();
+}
+
+void DownloadManager::release(JobPtr const& job) {
+    --_running;
+    if (--_runningPerHost[job->host] == 0) {
+        _runningPerHost.erase(job->host);
+    }
+    dispatch();
+}
+
+void DownloadManager::cancelJobs(std::function<bool(Job const&)> const& predicate) {
+    std::vector<JobPtr> cancelled;
+    for (auto const& [_, job] : _jobs) {
+        if (predicate(*job)) {
+            cancelled.push_back(job);
+        }
+    }
+    for (auto const& job : cancelled) {
+        spdlog::debug("Download cancelled: {}", job->url);
+        if (!job->started) {
+            _queue.remove(job);
+        }
+        finish(job, Err(Error(Error::Cancelled)));
+        // the owner aborts the transfer and gives back the slot
+        job->cancelSignal.cancel();
+    }
+}
+
+} // namespace evento
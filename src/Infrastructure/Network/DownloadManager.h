@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Infrastructure/Utils/Result.h>
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace evento {
+
+namespace net = boost::asio; // from <boost/asio.hpp>
+
+template<typename T>
+using Task = net::awaitable<T>;
+
+// lower value is served first
+enum class DownloadPriority {
+    Visible = 0, // on screen right now, e.g. the current slide
+    Prefetch,    // likely to be shown soon, e.g. the other slides
+    Background,  // off-screen, e.g. contributor avatars
+};
+
+// called in the io thread with received bytes and total bytes (if known),
+// use `slint::invoke_from_event_loop` before touching the UI
+using DownloadProgress = std::function<void(std::size_t received,
+                                            std::optional<std::size_t> total)>;
+
+// Schedules file downloads in front of `NetworkClient::getFile`:
+// - requests of the same url in flight are merged into one download
+// - at most `maxConcurrent` downloads overall and `maxPerHost` per host run at once
+// - queued downloads start by priority, then by arrival
+// - queued or running downloads can be cancelled, their waiters get `Error::Cancelled`,
+//   a running transfer is aborted and frees its slot right away
+//
+// All members must be called in the io thread.
+class DownloadManager {
+public:
+    using Fetcher = std::function<Task<Result<std::filesystem::path>>(std::string url,
+                                                                       DownloadProgress progress)>;
+
+    DownloadManager(std::size_t maxConcurrent = 6, std::size_t maxPerHost = 4);
+    DownloadManager(const DownloadManager&) = delete;
+    DownloadManager& operator=(const DownloadManager&) = delete;
+
+    // `fetch` is only invoked if no download of `url` is in flight
+    Task<Result<std::filesystem::path>> download(std::string url,
+                                                 DownloadPriority priority,
+                                                 DownloadProgress progress,
+                                                 Fetcher fetch);
+
+    void cancel(std::string const& url);
+    // cancel every download as urgent as `priority` or less
+    void cancel(DownloadPriority priority);
+
+    [[nodiscard]] std::size_t runningCount() const { return _running; }
+    [[nodiscard]] std::size_t queuedCount() const { return _queue.size(); }
+
+private:
+    struct Job {
+        std::string url;
+        std::string host;
+        DownloadPriority priority;
+        std::uint64_t sequence;
+        std::vector<DownloadProgress> progress;
+        std::optional<Result<std::filesystem::path>> result;
+        bool started = false;
+        // woken once when the job may start, and once when it is finished
+        net::steady_timer startSignal;
+        net::steady_timer doneSignal;
+        // woken when cancelled, aborts the transfer
+        net::steady_timer cancelSignal;
+
+        Job(net::any_io_executor const& executor)
+            : startSignal(executor, net::steady_timer::time_point::max())
+            , doneSignal(executor, net::steady_timer::time_point::max())
+            , cancelSignal(executor, net::steady_timer::time_point::max()) {}
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    bool canStart(std::string const& host) const;
+    void enqueue(JobPtr const& job);
+    // start as many queued jobs as the limits allow
+    void dispatch();
+    void finish(JobPtr const& job, Result<std::filesystem::path> result);
+    // give back the slot of a started job
+    void release(JobPtr const& job);
+    void cancelJobs(std::function<bool(Job const&)> const& predicate);
+
+    std::size_t _maxConcurrent;
+    std::size_t _maxPerHost;
+    std::size_t _running = 0;
+    std::uint64_t _nextSequence = 0;
+    std::unordered_map<std::string, std::size_t> _runningPerHost;
+    std::unordered_map<std::string, JobPtr> _jobs; // url -> job in flight or queued
+    std::list<JobPtr> _queue;                      // sorted by priority, then sequence
+};
+
+} // namespace evento
@@ -0,0 +1,87 @@
+#include <Infrastructure/Network/EventStream.h>
+#include <algorithm>
+#include <charconv>
+
+namespace evento {
+
+void EventStreamParser::append(std::string_view bytes) {
+    if (_failed) {
+        return;
+    }
+    for (auto c : bytes) {
+        if (_skipLineFeed) {
+            _skipLineFeed = false;
+            if (c == '\n') {
+                continue;
+            }
+        }
+        if (c == '\r' || c == '\n') {
+            _skipLineFeed = c == '\r';
+            line(_line);
+            _line.clear();
+            continue;
+        }
+        if (_line.size() >= MAX_LINE) {
+            _failed = true;
+            return;
+        }
+        _line += c;
+    }
+}
+
+std::optional<ServerSentEvent> EventStreamParser::next() {
+    if (_ready.empty()) {
+        return std::nullopt;
+    }
+    auto event = std::move(_ready.front());
+    _ready.pop_front();
+    return event;
+}
+
+void EventStreamParser::line(std::string_view line) {
+    if (line.empty()) {
+        // dispatch, an event without data only updates the id
+        if (_hasData) {
+            _event.id = _lastEventId;
+            _ready.push_back(std::move(_event));
+        }
+        _event = {};
+        _hasData = false;
+        return;
+    }
+    if (line.front() == ':') {
+        return;
+    }
+
+    auto colon = line.find(':');
+    auto field = line.substr(0, colon);
+    std::string_view value;
+    if (colon != std::string_view::npos) {
+        value = line.substr(colon + 1);
+        if (value.starts_with(' ')) {
+            value.remove_prefix(1);
+        }
+    }
+
+    if (field == "event") {
+        _event.type = value.empty() ? "message" : value;
+    } else if (field == "data") {
+        if (_hasData) {
+            _event.data += '\n';
+        }
+        _event.data += value;
+        _hasData = true;
+    } else if (field == "id") {
+        if (value.find('\0') == std::string_view::npos) {
+            _lastEventId = value;
+        }
+    } else if (field == "retry") {
+        std::size_t retry = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), retry);
+        if (ec == std::errc{} && end == value.data() + value.size()) {
+            _retry = retry;
+        }
+    }
+}
+
+} // namespace evento
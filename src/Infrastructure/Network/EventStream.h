@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace evento {
+
+// one event of a `text/event-stream` body
+struct ServerSentEvent {
+    std::string type = "message"; // the `event` field
+    std::string data;             // `data` lines joined by '\n'
+    std::string id;               // the last event id, as of this event
+};
+
+// Splits a `text/event-stream` body into events as its bytes arrive, in chunks of any size:
+// lines end with "\r\n", '\n' or '\r', a blank line ends an event, lines starting with ':'
+// are comments (heartbeats), fields other than `event`, `data`, `id` and `retry` are ignored.
+class EventStreamParser {
+public:
+    void append(std::string_view bytes);
+    // the next complete event, if any
+    std::optional<ServerSentEvent> next();
+
+    // to resume with `Last-Event-ID` after a reconnect
+    [[nodiscard]] std::string const& lastEventId() const { return _lastEventId; }
+    // reconnection delay asked by the server in milliseconds
+    [[nodiscard]] std::optional<std::size_t> retry() const { return _retry; }
+    // a line longer than `MAX_LINE`, the stream cannot be trusted anymore
+    [[nodiscard]] bool failed() const { return _failed; }
+
+    static constexpr std::size_t MAX_LINE = 1024 * 1024;
+
+private:
+    void line(std::string_view line);
+
+    std::string _line;
+    bool _skipLineFeed = false; // after '\r', the '\n' of a "\r\n" may follow in the next chunk
+    ServerSentEvent _event;
+    bool _hasData = false;
+    std::deque<ServerSentEvent> _ready;
+    std::string _lastEventId;
+    std::optional<std::size_t> _retry;
+    bool _failed = false;
+};
+
+} // namespace evento
@@ -1,36 +1,179 @@
+#include <Infrastructure/Network/ContentDecoder.h>
 #include <Infrastructure/Network/HttpsAccessManager.h>
 #include <Infrastructure/Utils/Result.h>
+#include <Infrastructure/Utils/Trace.h>
+#include <algorithm>
 #include <boost/asio/error.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/system/system_error.hpp>
 #include <chrono>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace evento {
 
-Task<ResponseResult> HttpsAccessManager::makeReply(std::string host,
-                                                   http::request<http::string_body> req) {
+namespace fs = std::filesystem;
+
+namespace {
+
+// destination of a streamed body, appended chunk by chunk
+class DownloadFile {
+public:
+    explicit DownloadFile(net::any_io_executor const& executor)
+#if !defined(PLATFORM_APPLE)
+        : _file(executor)
+#endif
+    {
+    }
+
+    bool open(fs::path const& path, bool append) {
+#if defined(PLATFORM_APPLE)
+        _file.open(path,
+                   std::ios::binary | std::ios::out | (append ? std::ios::app : std::ios::trunc));
+        return _file.is_open();
+#else
+        beast::error_code ec;
+        _file.open(path.string(),
+                   net::stream_file::write_only | net::stream_file::create
+                       | (append ? net::stream_file::append : net::stream_file::truncate),
+                   ec);
+        return !ec;
+#endif
+    }
+
+    Task<bool> write(const char* data, std::size_t size) {
+#if defined(PLATFORM_APPLE)
+        _file.write(data, static_cast<std::streamsize>(size));
+        co_return _file.good();
+#else
+        auto [ec, _] = co_await net::async_write(_file,
+                                                 net::buffer(data, size),
+                                                 net::as_tuple(net::use_awaitable));
+        co_return !ec;
+#endif
+    }
+
+    // an open file cannot be removed on Windows
+    void close() {
+#if defined(PLATFORM_APPLE)
+        _file.close();
+#else
+        beast::error_code ec;
+        _file.close(ec);
+#endif
+    }
+
+private:
+#if defined(PLATFORM_APPLE)
+    std::ofstream _file;
+#else
+    net::stream_file _file;
+#endif
+};
+
+fs::path metaPathOf(fs::path const& path) {
+    auto meta = path;
+    meta += ".meta";
+    return meta;
+}
+
+// `If-Range` only accepts a strong entity tag or a date
+std::string validatorOf(http::response_header<> const& header) {
+    if (auto etag = header.find(http::field::etag);
+        etag != header.end() && !etag->value().starts_with("W/")) {
+        return std::string(etag->value());
+    }
+    if (auto lastModified = header.find(http::field::last_modified);
+        lastModified != header.end()) {
+        return std::string(lastModified->value());
+    }
+    return {};
+}
+
+// the server closed a keep-alive connection while it was idle in the pool
+bool isStaleConnection(beast::error_code const& ec) {
+    return ec == http::error::end_of_stream || ec == net::error::eof
+           || ec == net::error::connection_reset || ec == net::error::broken_pipe
+           || ec == ssl::error::stream_truncated;
+}
+
+RequestTiming::Duration elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<RequestTiming::Duration>(std::chrono::steady_clock::now()
+                                                               - start);
+}
+
+Error transferError(beast::error_code const& ec, std::string_view operation) {
+    if (ec == beast::error::timeout || ec == net::error::timed_out) {
+        return Error(Error::Timeout, std::format("{} operation timed out", operation));
+    }
+    return Error(Error::Network, ec.message());
+}
+
+// "host:port" into the name to resolve and the service, "https" without a port
+std::pair<std::string, std::string> splitHostPort(std::string const& host) {
+    auto colon = host.rfind(':');
+    if (colon == std::string::npos || host.find(']', colon) != std::string::npos) {
+        return {host, "https"};
+    }
+    auto name = host.substr(0, colon);
+    if (name.size() >= 2 && name.front() == '[' && name.back() == ']') {
+        name = name.substr(1, name.size() - 2);
+    }
+    return {name, host.substr(colon + 1)};
+}
+
+} // namespace
+
+HttpsAccessManager::ssl_stream HttpsAccessManager::makeStream(
+    net::any_io_executor const& executor) {
+    // We construct the ssl stream from the already rebound tcp_stream.
+    return ssl_stream{boost::asio::use_awaitable_t<boost::asio::any_io_executor>::as_default_on(
+                          beast::tcp_stream(executor)),
+                      _ctx};
+}
+
+Task<Result<void>> HttpsAccessManager::connect(ssl_stream& stream,
+                                               std::string const& host,
+                                               RequestTiming& timing) {
+    std::call_once(_verifyPathsLoaded, [this] { _ctx.set_default_verify_paths(); });
+
     auto resolver = net::use_awaitable_t<boost::asio::any_io_executor>::as_default_on(
         tcp::resolver(co_await net::this_coro::executor));
 
-    // We construct the ssl stream from the already rebound tcp_stream.
-    beast::ssl_stream<tcp_stream>
-        stream{boost::asio::use_awaitable_t<boost::asio::any_io_executor>::as_default_on(
-                   beast::tcp_stream(co_await net::this_coro::executor)),
-               _ctx};
+    auto [name, service] = splitHostPort(host);
 
     // Set SNI Hostname (many hosts need this to handshake successfully)
-    if (!SSL_set_tlsext_host_name(stream.native_handle(), host.c_str()))
-        throw boost::system::system_error(static_cast<int>(::ERR_get_error()),
-                                          net::error::get_ssl_category());
+    if (!SSL_set_tlsext_host_name(stream.native_handle(), name.c_str())) {
+        beast::error_code ec(static_cast<int>(::ERR_get_error()), net::error::get_ssl_category());
+        co_return Err(Error(Error::Network, ec.message()));
+    }
+
+    // Look up the domain name, a failure counts like any other connection problem
+    auto resolveStart = std::chrono::steady_clock::now();
+    TraceAsyncSpan resolveSpan("network", "resolve", timing.traceId);
+    auto [resolveError, results] =
+        co_await resolver.async_resolve(name, service, net::as_tuple(net::use_awaitable));
+    if (resolveError) {
+        co_return Err(Error(Error::Network, std::format("Resolve: {}", resolveError.message())));
+    }
+    resolveSpan.end();
+    timing.resolve = elapsedSince(resolveStart);
 
-    // Look up the domain name
-    auto const results = co_await resolver.async_resolve(host, "https");
+    auto deadlines = _latency.deadlines(host);
 
     // Set the timeout.
-    beast::get_lowest_layer(stream).expires_after(_timeout);
+    beast::get_lowest_layer(stream).expires_after(deadlines.connect);
 
     // Make the connection on the IP address we get from a lookup
+    auto connectStart = std::chrono::steady_clock::now();
+    TraceAsyncSpan connectSpan("network", "connect", timing.traceId);
     try {
         co_await beast::get_lowest_layer(stream).async_connect(results);
     } catch (const boost::system::system_error& e) {
@@ -39,56 +182,767 @@ Task<ResponseResult> HttpsAccessManager::makeReply(std::string host,
         }
         co_return Err(Error(Error::Network, e.what()));
     }
+    connectSpan.end();
+    timing.connect = elapsedSince(connectStart);
+    _latency.recordRtt(host, timing.connect);
 
     // Set the timeout.
-    beast::get_lowest_layer(stream).expires_after(_timeout);
+    beast::get_lowest_layer(stream).expires_after(deadlines.handshake);
 
     // Perform the SSL handshake
+    auto handshakeStart = std::chrono::steady_clock::now();
+    TraceAsyncSpan handshakeSpan("network", "handshake", timing.traceId);
     try {
         co_await stream.async_handshake(ssl::stream_base::client);
     } catch (const boost::system::system_error& e) {
         co_return Err(Error(Error::Ssl, e.what()));
     }
+    timing.handshake = elapsedSince(handshakeStart);
+
+    co_return Ok();
+}
+
+Task<beast::error_code> HttpsAccessManager::shutdown(ssl_stream& stream) {
+    beast::get_lowest_layer(stream).expires_after(std::chrono::seconds(2));
+
+    // Gracefully close the stream - do not threat every error as an exception!
+    auto [ec] = co_await stream.async_shutdown(net::as_tuple(net::use_awaitable));
+    if (!ec || ec == net::error::eof || (ignoreSslError && ec == ssl::error::stream_truncated)
+        || ec == beast::error::timeout) {
+        // If we get here then the connection is closed gracefully
+        co_return beast::error_code{};
+    }
+    co_return ec;
+}
 
+HttpsAccessManager::ConnectionPtr HttpsAccessManager::takeIdle(std::string const& host) {
+    auto it = _idle.find(host);
+    if (it == _idle.end()) {
+        return nullptr;
+    }
+    auto& connections = it->second;
+    auto now = std::chrono::steady_clock::now();
+    while (!connections.empty()) {
+        auto connection = std::move(connections.back());
+        connections.pop_back();
+        if (now - connection->idleSince < IDLE_TIMEOUT) {
+            connection->reused = true;
+            return connection;
+        }
+        // too old, the server has most likely dropped it already
+    }
+    _idle.erase(it);
+    return nullptr;
+}
+
+bool HttpsAccessManager::hasIdle(std::string const& host) const {
+    auto it = _idle.find(host);
+    return it != _idle.end() && !it->second.empty()
+           && std::chrono::steady_clock::now() - it->second.back()->idleSince < IDLE_TIMEOUT;
+}
+
+void HttpsAccessManager::putIdle(std::string const& host, ConnectionPtr connection) {
+    auto& connections = _idle[host];
+    if (connections.size() >= MAX_IDLE_PER_HOST) {
+        connections.erase(connections.begin());
+    }
+    connection->idleSince = std::chrono::steady_clock::now();
+    connections.push_back(std::move(connection));
+}
+
+Task<beast::error_code> HttpsAccessManager::release(std::string const& host,
+                                                    ConnectionPtr connection,
+                                                    bool keepAlive) {
+    if (keepAlive) {
+        putIdle(host, std::move(connection));
+        co_return beast::error_code{};
+    }
+    co_return co_await shutdown(connection->stream);
+}
+
+template<typename Parser>
+Task<Result<void>> HttpsAccessManager::openExchange(std::string const& host,
+                                                    http::request<http::string_body>& req,
+                                                    ConnectionPtr& connection,
+                                                    std::optional<Parser>& parser,
+                                                    boost::optional<std::uint64_t> bodyLimit,
+                                                    PhaseDeadlines const& deadlines,
+                                                    RequestTiming& timing) {
+    while (true) {
+        timing.resolve = timing.connect = timing.handshake = {};
+        connection = takeIdle(host);
+        if (!connection) {
+            connection = std::make_unique<Connection>(
+                Connection{.stream = makeStream(co_await net::this_coro::executor)});
+            if (auto connected = co_await connect(connection->stream, host, timing);
+                connected.isErr()) {
+                co_return Err(connected.unwrapErr());
+            }
+        }
+        timing.reused = connection->reused;
+
+        parser.emplace();
+        parser->body_limit(bodyLimit);
+
+        // Set the timeout
+        beast::get_lowest_layer(connection->stream).expires_after(deadlines.write);
+        auto writeStart = std::chrono::steady_clock::now();
+        TraceAsyncSpan waitSpan("network", "wait", timing.traceId);
+
+        // Send the HTTP request to the remote host
+        auto [writeError, written] = co_await http::async_write(connection->stream,
+                                                                req,
+                                                                net::as_tuple(net::use_awaitable));
+        if (writeError) {
+            if (connection->reused && isStaleConnection(writeError)) {
+                continue;
+            }
+            co_return Err(transferError(writeError, "Write"));
+        }
+
+        // Set the timeout
+        beast::get_lowest_layer(connection->stream).expires_after(deadlines.read);
+
+        // Receive the HTTP response header
+        auto [readError, read] = co_await http::async_read_header(connection->stream,
+                                                                  connection->buffer,
+                                                                  *parser,
+                                                                  net::as_tuple(
+                                                                      net::use_awaitable));
+        if (readError) {
+            if (connection->reused && isStaleConnection(readError)) {
+                spdlog::debug("Pooled connection to {} was closed: {}", host, readError.message());
+                continue;
+            }
+            co_return Err(transferError(readError, "Read"));
+        }
+        timing.firstByte = elapsedSince(writeStart);
+        co_return Ok();
+    }
+}
+
+Task<void> HttpsAccessManager::warmUp(std::string host) {
+    if (replaying() || _warmingUp.contains(host)
+        || _circuitBreaker.state(host) != CircuitBreaker::State::Closed) {
+        co_return;
+    }
+    if (hasIdle(host)) {
+        co_return;
+    }
+
+    _warmingUp.insert(host);
+    auto connection = std::make_unique<Connection>(
+        Connection{.stream = makeStream(co_await net::this_coro::executor)});
+    RequestTiming timing;
+    auto connected = co_await connect(connection->stream, host, timing);
+    _warmingUp.erase(host);
+    if (connected.isErr()) {
+        spdlog::debug("Warm-up of {} failed: {}", host, connected.unwrapErr().what());
+        co_return;
+    }
+    spdlog::debug("Connection to {} warmed up in {}ms",
+                  host,
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                      timing.resolve + timing.connect + timing.handshake)
+                      .count());
+    putIdle(host, std::move(connection));
+}
+
+Task<ResponseResult> HttpsAccessManager::makeReply(std::string host,
+                                                   http::request<http::string_body> req,
+                                                   RequestTiming* timing) {
+    auto start = std::chrono::steady_clock::now();
+    if (replaying()) {
+        auto result = co_await replayReply(TrafficArchive::keyOf(host, req));
+        if (timing) {
+            *timing = {.total = elapsedSince(start), .attempts = 1, .failed = result.isErr()};
+        }
+        co_return result;
+    }
+    auto traceId = tracer()->enabled() ? tracer()->newId() : 0;
+    TraceAsyncSpan span("network",
+                        "request",
+                        traceId,
+                        traceId ? std::format("{}{}", host, std::string(req.target())) : "");
+    RequestTiming attemptTiming;
+    int attempts = 0;
+    auto verb = req.method();
+    auto result = co_await withRetry<http::response<http::dynamic_body>>(host, verb, [&]() {
+        attemptTiming = {.traceId = traceId};
+        ++attempts;
+        return verb == http::verb::get && hedging ? sendHedged(host, req, attemptTiming)
+                                                  : sendRequest(host, req, attemptTiming);
+    });
+    if (recording() && result.isOk()) {
+        auto res = result.unwrap();
+        _archive->add(TrafficArchive::keyOf(host, req),
+                      std::chrono::steady_clock::now() - start,
+                      res.base(),
+                      beast::buffers_to_string(res.body().data()));
+    }
+    if (timing) {
+        *timing = attemptTiming;
+        timing->attempts = attempts;
+        timing->total = elapsedSince(start);
+        timing->failed = result.isErr();
+    }
+    co_return result;
+}
+
+Task<DownloadResult> HttpsAccessManager::makeDownload(std::string host,
+                                                      http::request<http::string_body> req,
+                                                      fs::path path,
+                                                      DownloadProgress progress,
+                                                      RequestTiming* timing) {
+    auto start = std::chrono::steady_clock::now();
+    if (replaying()) {
+        auto result = co_await replayDownload(TrafficArchive::keyOf(host, req),
+                                              std::move(path),
+                                              std::move(progress));
+        if (timing) {
+            *timing = {.total = elapsedSince(start), .attempts = 1, .failed = result.isErr()};
+        }
+        co_return result;
+    }
+    auto traceId = tracer()->enabled() ? tracer()->newId() : 0;
+    TraceAsyncSpan span("network",
+                        "download",
+                        traceId,
+                        traceId ? std::format("{}{}", host, std::string(req.target())) : "");
+    RequestTiming attemptTiming;
+    int attempts = 0;
+    // a retry resumes from what the failed attempt has written
+    auto verb = req.method();
+    auto result = co_await withRetry<http::response_header<>>(host, verb, [&]() {
+        attemptTiming = {.traceId = traceId};
+        ++attempts;
+        return sendDownload(host, req, path, progress, attemptTiming);
+    });
+    if (recording() && result.isOk()) {
+        // a resumed body is recorded as a whole, replay starts from scratch
+        auto header = result.unwrap();
+        std::string body;
+        if (header.result() == http::status::ok
+            || header.result() == http::status::partial_content) {
+            std::ifstream file(path, std::ios::binary);
+            body.assign(std::istreambuf_iterator<char>(file), {});
+            header.result(http::status::ok);
+            header.erase(http::field::content_range);
+            header.set(http::field::content_length, std::to_string(body.size()));
+        }
+        _archive->add(TrafficArchive::keyOf(host, req),
+                      std::chrono::steady_clock::now() - start,
+                      header,
+                      std::move(body));
+    }
+    if (timing) {
+        *timing = attemptTiming;
+        timing->attempts = attempts;
+        timing->total = elapsedSince(start);
+        timing->failed = result.isErr();
+    }
+    co_return result;
+}
+
+Task<DownloadResult> HttpsAccessManager::makeEventStream(std::string host,
+                                                         http::request<http::string_body> req,
+                                                         EventStreamHandler handler) {
+    if (replaying()) {
+        co_return Err(Error(Error::Network, "event streams are not replayed"));
+    }
+    if (_circuitBreaker.state(host) == CircuitBreaker::State::Open) {
+        co_return Err(Error(Error::Network, std::format("circuit of {} is open", host)));
+    }
+    auto traceId = tracer()->enabled() ? tracer()->newId() : 0;
+    TraceAsyncSpan span("network",
+                        "stream",
+                        traceId,
+                        traceId ? std::format("{}{}", host, std::string(req.target())) : "");
+    RequestTiming timing{.traceId = traceId};
+
+    req.set(http::field::accept, "text/event-stream");
+    req.set(http::field::cache_control, "no-cache");
+    // events are small and must not wait in a decoder
+    req.set(http::field::accept_encoding, "identity");
     req.prepare_payload();
 
-    // Set the timeout
-    beast::get_lowest_layer(stream).expires_after(_timeout);
+    // a long-lived connection, never taken from or returned to the pool
+    auto connection = std::make_unique<Connection>(
+        Connection{.stream = makeStream(co_await net::this_coro::executor)});
+    auto& stream = connection->stream;
+    if (auto connected = co_await connect(stream, host, timing); connected.isErr()) {
+        co_return Err(connected.unwrapErr());
+    }
 
-    // Send the HTTP request to the remote host
-    try {
-        co_await http::async_write(stream, req);
-    } catch (const boost::system::system_error& e) {
-        if (e.code() == net::error::timed_out) {
-            co_return Err(Error(Error::Timeout, "Write operation timed out"));
+    auto deadlines = _latency.deadlines(host);
+    beast::get_lowest_layer(stream).expires_after(deadlines.write);
+    auto [writeError, written] = co_await http::async_write(stream,
+                                                            req,
+                                                            net::as_tuple(net::use_awaitable));
+    if (writeError) {
+        co_return Err(transferError(writeError, "Write"));
+    }
+
+    http::response_parser<http::buffer_body> parser;
+    parser.body_limit(boost::none);
+    beast::get_lowest_layer(stream).expires_after(deadlines.read);
+    auto [readError, read] = co_await http::async_read_header(stream,
+                                                              connection->buffer,
+                                                              parser,
+                                                              net::as_tuple(net::use_awaitable));
+    if (readError) {
+        co_return Err(transferError(readError, "Read"));
+    }
+
+    auto& res = parser.get();
+    http::response_header<> header = res.base();
+    auto contentType = res.find(http::field::content_type);
+    if (res.result() != http::status::ok || contentType == res.end()
+        || !contentType->value().starts_with("text/event-stream")) {
+        co_await shutdown(stream);
+        co_return Ok(header);
+    }
+    if (handler.opened) {
+        handler.opened();
+    }
+
+    EventStreamParser events;
+    std::vector<char> chunk(DOWNLOAD_CHUNK_SIZE);
+    while (!parser.is_done()) {
+        res.body().data = chunk.data();
+        res.body().size = chunk.size();
+
+        // heartbeats keep it from expiring while nothing changes
+        beast::get_lowest_layer(stream).expires_after(STREAM_IDLE_TIMEOUT);
+        auto [ec, _] = co_await http::async_read_some(stream,
+                                                      connection->buffer,
+                                                      parser,
+                                                      net::as_tuple(net::use_awaitable));
+        if (ec == http::error::need_buffer) {
+            ec = {};
+        }
+        if (ec) {
+            co_return Err(transferError(ec, "Read"));
+        }
+
+        auto size = chunk.size() - res.body().size;
+        _stats.wireBytes += size;
+        _stats.decodedBytes += size;
+        events.append(std::string_view(chunk.data(), size));
+        if (events.failed()) {
+            co_return Err(Error(Error::Data, "event stream line too long"));
+        }
+        while (auto event = events.next()) {
+            handler.event(std::move(*event));
         }
-        co_return Err(Error(Error::Network, e.what()));
     }
+    co_await shutdown(stream);
+    co_return Ok(header);
+}
 
-    // Declare a container to hold the response
-    http::response<http::dynamic_body> res;
+Task<ResponseResult> HttpsAccessManager::replayReply(std::string const& key) {
+    auto entry = _archive->next(key);
+    if (!entry) {
+        co_return Err(Error(Error::Data, std::format("not in the traffic archive: {}", key)));
+    }
+    net::steady_timer timer(co_await net::this_coro::executor, _archive->delayOf(*entry));
+    co_await timer.async_wait(net::use_awaitable);
 
-    beast::flat_buffer buffer;
+    http::response<http::dynamic_body> res(TrafficArchive::headerOf(*entry));
+    auto size = entry->body.size();
+    res.body().commit(net::buffer_copy(res.body().prepare(size), net::buffer(entry->body)));
+    co_return Ok(std::move(res));
+}
 
-    // Receive the HTTP response
-    try {
-        co_await http::async_read(stream, buffer, res);
-    } catch (const boost::system::system_error& e) {
-        if (e.code() == net::error::timed_out) {
-            co_return Err(Error(Error::Timeout, "Read operation timed out"));
+Task<DownloadResult> HttpsAccessManager::replayDownload(std::string const& key,
+                                                        fs::path path,
+                                                        DownloadProgress progress) {
+    auto entry = _archive->next(key);
+    if (!entry) {
+        co_return Err(Error(Error::Data, std::format("not in the traffic archive: {}", key)));
+    }
+    net::steady_timer timer(co_await net::this_coro::executor, _archive->delayOf(*entry));
+    co_await timer.async_wait(net::use_awaitable);
+
+    auto header = TrafficArchive::headerOf(*entry);
+    if (header.result() == http::status::ok) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(entry->body.data(), static_cast<std::streamsize>(entry->body.size()));
+        if (!file.good()) {
+            co_return Err(Error(Error::Data, std::format("cannot write {}", path.string())));
+        }
+        std::error_code ec;
+        fs::remove(metaPathOf(path), ec);
+        if (progress) {
+            progress(entry->body.size(), entry->body.size());
         }
-        co_return Err(Error(Error::Network, e.what()));
     }
-    beast::get_lowest_layer(stream).expires_after(std::chrono::seconds(2));
+    co_return Ok(std::move(header));
+}
 
-    // Gracefully close the stream - do not threat every error as an exception!
-    auto [ec] = co_await stream.async_shutdown(net::as_tuple(net::use_awaitable));
-    if (!ec || ec == net::error::eof || (ignoreSslError && ec == ssl::error::stream_truncated)
-        || ec == beast::error::timeout) {
-        // If we get here then the connection is closed gracefully
-        co_return Ok(res);
+template<typename Response>
+Task<Result<Response>> HttpsAccessManager::withRetry(
+    std::string const& host, http::verb verb, std::function<Task<Result<Response>>()> send) {
+    bool idempotent = verb == http::verb::get || verb == http::verb::head
+                      || verb == http::verb::options;
+    auto attempts = idempotent ? std::max(retryPolicy.maxAttempts, 1) : 1;
+
+    for (int attempt = 1;; ++attempt) {
+        if (!_circuitBreaker.allow(host)) {
+            co_return Err(Error(Error::Unavailable,
+                                std::format("{} is unavailable, try again later", host)));
+        }
+
+        // settled below unless `send` throws or the coroutine is destroyed while waiting
+        struct Outcome {
+            CircuitBreaker& breaker;
+            std::string const& host;
+            bool recorded = false;
+            ~Outcome() {
+                if (!recorded) {
+                    breaker.recordAbandoned(host);
+                }
+            }
+        } outcome{_circuitBreaker, host};
+
+        auto result = co_await send();
+        outcome.recorded = true;
+
+        // connection problems and gateway errors are worth another try, anything else is not
+        std::string failure;
+        if (result.isErr()) {
+            auto error = result.unwrapErr();
+            if (error.kind == Error::Network || error.kind == Error::Timeout) {
+                failure = error.what();
+            }
+        } else if (auto status = result.unwrap().result();
+                   status == http::status::bad_gateway
+                   || status == http::status::service_unavailable
+                   || status == http::status::gateway_timeout) {
+            failure = std::to_string(static_cast<unsigned>(status));
+        }
+
+        if (failure.empty()) {
+            _circuitBreaker.recordSuccess(host);
+            co_return result;
+        }
+        _circuitBreaker.recordFailure(host);
+        if (attempt >= attempts) {
+            co_return result;
+        }
+
+        auto delay = retryPolicy.delay(attempt - 1, _random);
+        spdlog::warn("Request to {} failed ({}), retry {} in {}ms",
+                     host,
+                     failure,
+                     attempt,
+                     delay.count());
+        net::steady_timer timer(co_await net::this_coro::executor, delay);
+        co_await timer.async_wait(net::as_tuple(net::use_awaitable));
+    }
+}
+
+Task<ResponseResult> HttpsAccessManager::sendHedged(std::string host,
+                                                    http::request<http::string_body> req,
+                                                    RequestTiming& timing) {
+    using namespace net::experimental::awaitable_operators;
+
+    auto delay = _latency.hedgeDelay(host);
+    if (!delay) {
+        co_return co_await sendRequest(std::move(host), std::move(req), timing);
     }
 
-    co_return Err(Error(Error::Network, ec.message()));
+    // a track of its own, its phases overlap with those of the first attempt
+    RequestTiming hedgedTiming{.traceId = timing.traceId ? tracer()->newId() : 0};
+    auto winner = co_await (sendRequest(host, req, timing)
+                            || sendDelayed(host, req, *delay, hedgedTiming));
+    if (winner.index() == 1) {
+        timing = hedgedTiming;
+    }
+    co_return std::visit([](auto& result) { return ResponseResult(std::move(result)); }, winner);
+}
+
+Task<ResponseResult> HttpsAccessManager::sendDelayed(std::string host,
+                                                     http::request<http::string_body> req,
+                                                     std::chrono::milliseconds delay,
+                                                     RequestTiming& timing) {
+    net::steady_timer timer(co_await net::this_coro::executor, delay);
+    co_await timer.async_wait(net::use_awaitable);
+    spdlog::debug("Request to {} is slower than p95 ({}ms), hedging", host, delay.count());
+    co_return co_await sendRequest(std::move(host), std::move(req), timing);
 }
-} // namespace evento
\ No newline at end of file
+
+Task<ResponseResult> HttpsAccessManager::sendRequest(std::string host,
+                                                     http::request<http::string_body> req,
+                                                     RequestTiming& timing) {
+    TraceAsyncSpan span("network", "attempt", timing.traceId);
+    if (req.find(http::field::accept_encoding) == req.end()) {
+        req.set(http::field::accept_encoding, ContentDecoder::ACCEPT_ENCODING);
+    }
+    req.prepare_payload();
+
+    auto deadlines = _latency.deadlines(host);
+    auto requestStart = std::chrono::steady_clock::now();
+
+    ConnectionPtr connection;
+    std::optional<http::response_parser<http::dynamic_body>> parser;
+    if (auto opened = co_await openExchange(host,
+                                            req,
+                                            connection,
+                                            parser,
+                                            MAX_REPLY_BODY_SIZE,
+                                            deadlines,
+                                            timing);
+        opened.isErr()) {
+        co_return Err(opened.unwrapErr());
+    }
+
+    // Receive the rest of the HTTP response
+    auto transferStart = std::chrono::steady_clock::now();
+    TraceAsyncSpan bodySpan("network", "body", timing.traceId);
+    auto [ec, _] = co_await http::async_read(connection->stream,
+                                             connection->buffer,
+                                             *parser,
+                                             net::as_tuple(net::use_awaitable));
+    if (ec) {
+        co_return Err(transferError(ec, "Read"));
+    }
+    bodySpan.end();
+    timing.transfer = elapsedSince(transferStart);
+    _latency.recordLatency(host, std::chrono::steady_clock::now() - requestStart);
+
+    auto res = parser->release();
+    timing.bodyBytes = res.body().size();
+    if (auto ec = co_await release(host, std::move(connection), res.keep_alive())) {
+        co_return Err(Error(Error::Network, ec.message()));
+    }
+
+    if (auto decoded = decodeBody(res); decoded.isErr()) {
+        co_return Err(decoded.unwrapErr());
+    }
+    co_return Ok(res);
+}
+
+Result<void> HttpsAccessManager::decodeBody(http::response<http::dynamic_body>& res) {
+    auto wireSize = res.body().size();
+    _stats.wireBytes += wireSize;
+
+    auto contentEncoding = res.find(http::field::content_encoding);
+    if (contentEncoding == res.end()) {
+        _stats.decodedBytes += wireSize;
+        return Ok();
+    }
+    std::string encodingName(contentEncoding->value());
+    auto encoding = ContentDecoder::parse(encodingName);
+    if (!encoding) {
+        return Err(
+            Error(Error::Data, std::format("unsupported content encoding: {}", encodingName)));
+    }
+
+    ContentDecoder decoder(*encoding);
+    beast::multi_buffer decoded;
+    for (auto const& buffer : beast::buffers_range_ref(res.body().data())) {
+        decoder.feed(static_cast<const char*>(buffer.data()), buffer.size());
+        while (true) {
+            auto piece = decoder.read();
+            if (piece.isErr()) {
+                return Err(piece.unwrapErr());
+            }
+            auto data = piece.unwrap();
+            if (data.empty()) {
+                break;
+            }
+            if (decoded.size() + data.size() > MAX_REPLY_BODY_SIZE) {
+                return Err(Error(
+                    Error::Data,
+                    std::format("decoded body exceeds {} bytes", MAX_REPLY_BODY_SIZE)));
+            }
+            decoded.commit(net::buffer_copy(decoded.prepare(data.size()), net::buffer(data)));
+        }
+    }
+    if (auto finished = decoder.finish(); finished.isErr()) {
+        return Err(finished.unwrapErr());
+    }
+
+    _stats.decodedBytes += decoder.decodedSize();
+    spdlog::debug("Decoded {} body: {} -> {} bytes",
+                  encodingName,
+                  wireSize,
+                  decoder.decodedSize());
+
+    res.body() = std::move(decoded);
+    res.erase(http::field::content_encoding);
+    res.content_length(res.body().size());
+    return Ok();
+}
+
+Task<DownloadResult> HttpsAccessManager::sendDownload(std::string host,
+                                                      http::request<http::string_body> req,
+                                                      fs::path path,
+                                                      DownloadProgress progress,
+                                                      RequestTiming& timing) {
+    TraceAsyncSpan span("network", "attempt", timing.traceId);
+    auto metaPath = metaPathOf(path);
+
+    // resume only if we know what the partial content belongs to
+    std::uint64_t offset = 0;
+    std::string validator;
+    std::error_code fec;
+    if (fs::exists(path, fec)) {
+        std::ifstream meta(metaPath);
+        std::getline(meta, validator);
+        offset = fs::file_size(path, fec);
+        if (fec || validator.empty()) {
+            offset = 0;
+        }
+    }
+    if (offset > 0) {
+        req.set(http::field::range, std::format("bytes={}-", offset));
+        req.set(http::field::if_range, validator);
+    }
+
+    req.prepare_payload();
+
+    auto deadlines = _latency.deadlines(host);
+
+    // the body is pulled through a fixed chunk instead of a growing buffer
+    ConnectionPtr connection;
+    std::optional<http::response_parser<http::buffer_body>> parser;
+    if (auto opened =
+            co_await openExchange(host, req, connection, parser, boost::none, deadlines, timing);
+        opened.isErr()) {
+        co_return Err(opened.unwrapErr());
+    }
+    auto& stream = connection->stream;
+
+    auto& res = parser->get();
+    http::response_header<> header = res.base();
+
+    auto encoding = ContentDecoder::Encoding::Identity;
+    if (auto contentEncoding = res.find(http::field::content_encoding);
+        contentEncoding != res.end()) {
+        std::string encodingName(contentEncoding->value());
+        auto parsed = ContentDecoder::parse(encodingName);
+        if (!parsed) {
+            co_return Err(Error(Error::Data,
+                                std::format("unsupported content encoding: {}", encodingName)));
+        }
+        encoding = *parsed;
+    }
+    // ranges of an encoded body do not map onto the decoded bytes in `path`
+    bool encoded = encoding != ContentDecoder::Encoding::Identity;
+
+    bool resumed = offset > 0 && res.result() == http::status::partial_content;
+    if (resumed && encoded) {
+        fs::remove(path, fec);
+        fs::remove(metaPath, fec);
+        co_return Err(Error(Error::Network, "unexpected encoded content range"));
+    }
+    if (resumed) {
+        auto range = res.find(http::field::content_range);
+        if (range == res.end()
+            || !range->value().starts_with(std::format("bytes {}-", offset))) {
+            // not the range we asked for, the partial content cannot be trusted anymore
+            fs::remove(path, fec);
+            fs::remove(metaPath, fec);
+            co_return Err(Error(Error::Network, "unexpected content range"));
+        }
+    } else if (res.result() != http::status::ok) {
+        if (res.result() == http::status::range_not_satisfiable) {
+            fs::remove(path, fec);
+            fs::remove(metaPath, fec);
+        }
+        co_await shutdown(stream);
+        co_return Ok(header);
+    } else {
+        // a fresh body, remember its validator so that an interruption can be resumed
+        offset = 0;
+        validator = encoded ? std::string() : validatorOf(header);
+        if (validator.empty()) {
+            fs::remove(metaPath, fec);
+        } else {
+            std::ofstream(metaPath, std::ios::out | std::ios::trunc) << validator;
+        }
+    }
+
+    // progress counts bytes on the wire, the decoded size is unknown up front
+    std::optional<std::size_t> total;
+    if (auto length = parser->content_length()) {
+        total = offset + *length;
+    }
+
+    DownloadFile file(co_await net::this_coro::executor);
+    if (!file.open(path, resumed)) {
+        co_return Err(Error(Error::Data, std::format("failed to open file: {}", path.string())));
+    }
+
+    ContentDecoder decoder(encoding);
+    std::vector<char> chunk(DOWNLOAD_CHUNK_SIZE);
+    auto transferStart = std::chrono::steady_clock::now();
+    TraceAsyncSpan bodySpan("network", "body", timing.traceId);
+    std::size_t received = offset;
+    while (!parser->is_done()) {
+        res.body().data = chunk.data();
+        res.body().size = chunk.size();
+
+        // an idle timeout, a large body may take longer than any deadline as a whole
+        beast::get_lowest_layer(stream).expires_after(deadlines.read);
+        auto [ec, _] = co_await http::async_read(stream,
+                                                 connection->buffer,
+                                                 *parser,
+                                                 net::as_tuple(net::use_awaitable));
+        if (ec == http::error::need_buffer) {
+            ec = {};
+        }
+        if (ec) {
+            // keep the partial file, the next attempt picks up from here
+            co_return Err(transferError(ec, "Read"));
+        }
+
+        auto size = chunk.size() - res.body().size;
+        if (size == 0) {
+            continue;
+        }
+        decoder.feed(chunk.data(), size);
+        while (true) {
+            auto piece = decoder.read();
+            if (piece.isErr()) {
+                co_return Err(piece.unwrapErr());
+            }
+            auto data = piece.unwrap();
+            if (data.empty()) {
+                break;
+            }
+            if (decoder.decodedSize() > MAX_DECODED_DOWNLOAD_SIZE) {
+                // an encoded body is never resumed, nothing worth keeping
+                file.close();
+                fs::remove(path, fec);
+                co_return Err(Error(
+                    Error::Data,
+                    std::format("decoded download exceeds {} bytes", MAX_DECODED_DOWNLOAD_SIZE)));
+            }
+            if (!co_await file.write(data.data(), data.size())) {
+                co_return Err(
+                    Error(Error::Data, std::format("failed to write file: {}", path.string())));
+            }
+        }
+        received += size;
+        if (progress) {
+            progress(received, total);
+        }
+    }
+    if (auto finished = decoder.finish(); finished.isErr()) {
+        co_return Err(finished.unwrapErr());
+    }
+    fs::remove(metaPath, fec);
+    timing.transfer = elapsedSince(transferStart);
+    timing.bodyBytes = decoder.encodedSize();
+
+    _stats.wireBytes += decoder.encodedSize();
+    _stats.decodedBytes += decoder.decodedSize();
+
+    co_await release(host, std::move(connection), res.keep_alive());
+    co_return Ok(header);
+}
+
+} // namespace evento
@@ -1,12 +1,30 @@
 #pragma once
 
+#include <Infrastructure/Network/DownloadManager.h>
+#include <Infrastructure/Network/EventStream.h>
+#include <Infrastructure/Network/LatencyTracker.h>
+#include <Infrastructure/Network/NetworkMetrics.h>
+#include <Infrastructure/Network/RetryPolicy.h>
+#include <Infrastructure/Network/TrafficArchive.h>
 #include <Infrastructure/Utils/Result.h>
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
 #include <boost/url.hpp>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace evento {
 
@@ -19,10 +37,24 @@ namespace urls = boost::urls;     // from <boost/urls.hpp>
 template<typename T>
 using Task = net::awaitable<T>;
 using ResponseResult = Result<http::response<http::dynamic_body>>;
+using DownloadResult = Result<http::response_header<>>;
+
+// what `HttpsAccessManager::makeEventStream` reports while the stream is open
+struct EventStreamHandler {
+    std::function<void()> opened; // the response header accepted the stream
+    std::function<void(ServerSentEvent)> event;
+};
+
+// body bytes of all responses, as received and after content-decoding
+struct TransferStats {
+    std::atomic<std::uint64_t> wireBytes = 0;
+    std::atomic<std::uint64_t> decodedBytes = 0;
+};
 
 class HttpsAccessManager {
     using executor_with_default = net::use_awaitable_t<>::executor_with_default<net::any_io_executor>;
     using tcp_stream = typename beast::tcp_stream::rebind_executor<executor_with_default>::other;
+    using ssl_stream = beast::ssl_stream<tcp_stream>;
     using tcp = boost::asio::ip::tcp;
 
 public:
@@ -30,19 +62,150 @@ public:
                        std::chrono::seconds timeout = std::chrono::seconds(15))
         : _ctx(ssl::context::tlsv12_client)
         , ignoreSslError(ignoreSslError)
-        , _timeout(timeout) {
-        _ctx.set_default_verify_paths();
-    }
+        , _timeout(timeout)
+        , _latency(timeout) {}
 
-    // async send request to host and return response
+    // async send request to host and return response, `host` is "name" or "name:port"
     // `req.prepare_payload()` is called in the function
-    Task<ResponseResult> makeReply(std::string host, http::request<http::string_body> req);
+    // a compressed response body is decoded, `Accept-Encoding` is set unless `req` has one
+    // idempotent requests are retried on transient failures according to `retryPolicy`,
+    // requests to a host whose circuit is open fail fast with `Error::Network`
+    // a GET slower than the p95 latency of its host is hedged when `hedging` is set
+    // `timing`, if given, receives the phases of the last attempt
+    Task<ResponseResult> makeReply(std::string host,
+                                   http::request<http::string_body> req,
+                                   RequestTiming* timing = nullptr);
+
+    // async send request to host and stream the response body into `path`,
+    // at most `DOWNLOAD_CHUNK_SIZE` bytes of the body are held in memory at once.
+    // A partial `path` left by an interrupted transfer is resumed with `Range`/`If-Range`,
+    // using the validator (`ETag` or `Last-Modified`) kept next to it in `<path>.meta`.
+    // Returns the response header, the body is only written for `200` and `206`.
+    // A compressed body is decoded on the fly, but cannot be resumed.
+    Task<DownloadResult> makeDownload(std::string host,
+                                      http::request<http::string_body> req,
+                                      std::filesystem::path path,
+                                      DownloadProgress progress = {},
+                                      RequestTiming* timing = nullptr);
+
+    // async send request to host and dispatch the `text/event-stream` response to `handler`
+    // until the server ends it, which is `Ok` with the header. Any other response is `Ok`
+    // with its header as well, without a body. The stream has a connection of its own,
+    // it fails with `Error::Timeout` after `STREAM_IDLE_TIMEOUT` without a byte, heartbeats
+    // included. It is neither retried nor recorded, the caller reconnects.
+    Task<DownloadResult> makeEventStream(std::string host,
+                                         http::request<http::string_body> req,
+                                         EventStreamHandler handler);
+
+    // connect and handshake to `host` ahead of time, so that the next request can skip it,
+    // no-op if a connection to `host` is idle or being warmed up already
+    Task<void> warmUp(std::string host);
+
+    static constexpr std::size_t DOWNLOAD_CHUNK_SIZE = 64 * 1024;
+    // of a reply body, on the wire and once decoded alike
+    static constexpr std::uint64_t MAX_REPLY_BODY_SIZE = 8 * 1024 * 1024;
+    // of an encoded download once decoded, a small body must not inflate without end
+    static constexpr std::uint64_t MAX_DECODED_DOWNLOAD_SIZE = 64 * 1024 * 1024;
+    // keep-alive connections are reused for at most this long after their last response
+    static constexpr std::chrono::seconds IDLE_TIMEOUT{30};
+    static constexpr std::size_t MAX_IDLE_PER_HOST = 6;
+    static constexpr std::chrono::seconds STREAM_IDLE_TIMEOUT{60};
+
+    // record the responses of `makeReply` and `makeDownload` into `archive`, or answer them
+    // from it without network, see `TrafficArchive`
+    void setTrafficArchive(std::unique_ptr<TrafficArchive> archive) {
+        _archive = std::move(archive);
+    }
+    [[nodiscard]] bool replaying() const {
+        return _archive && _archive->mode() == TrafficArchive::Mode::Replay;
+    }
+
+    [[nodiscard]] TransferStats const& transferStats() const { return _stats; }
+    [[nodiscard]] LatencyTracker const& latency() const { return _latency; }
 
     bool ignoreSslError = false;
+    // send a second attempt once the first one exceeds the p95 latency of the host,
+    // whichever answers first wins and the other is cancelled. Off by default, slow GETs
+    // would double the load of a backend that is slow already, `EVENTO_HEDGING=1` turns it on.
+    bool hedging = false;
+    RetryPolicy retryPolicy;
 
 private:
+    // a TLS connection with the read buffer that goes along with it
+    struct Connection {
+        ssl_stream stream;
+        beast::flat_buffer buffer;
+        bool reused = false; // taken from the pool, the server may have closed it meanwhile
+        std::chrono::steady_clock::time_point idleSince;
+    };
+    using ConnectionPtr = std::unique_ptr<Connection>;
+
+    Task<ResponseResult> sendRequest(std::string host,
+                                     http::request<http::string_body> req,
+                                     RequestTiming& timing);
+    Task<ResponseResult> sendHedged(std::string host,
+                                    http::request<http::string_body> req,
+                                    RequestTiming& timing);
+    Task<ResponseResult> sendDelayed(std::string host,
+                                     http::request<http::string_body> req,
+                                     std::chrono::milliseconds delay,
+                                     RequestTiming& timing);
+    Task<DownloadResult> sendDownload(std::string host,
+                                      http::request<http::string_body> req,
+                                      std::filesystem::path path,
+                                      DownloadProgress progress,
+                                      RequestTiming& timing);
+    // run `send` under the circuit breaker of `host`, retrying transient failures
+    template<typename Response>
+    Task<Result<Response>> withRetry(std::string const& host,
+                                     http::verb verb,
+                                     std::function<Task<Result<Response>>()> send);
+
+    // send `req` on a pooled or new connection and read the response header into `parser`,
+    // a pooled connection closed by the server meanwhile is replaced by a new one
+    template<typename Parser>
+    Task<Result<void>> openExchange(std::string const& host,
+                                    http::request<http::string_body>& req,
+                                    ConnectionPtr& connection,
+                                    std::optional<Parser>& parser,
+                                    boost::optional<std::uint64_t> bodyLimit,
+                                    PhaseDeadlines const& deadlines,
+                                    RequestTiming& timing);
+    // keep the connection for later if the server allows it, close it otherwise
+    Task<beast::error_code> release(std::string const& host,
+                                    ConnectionPtr connection,
+                                    bool keepAlive);
+    ConnectionPtr takeIdle(std::string const& host);
+    bool hasIdle(std::string const& host) const;
+    void putIdle(std::string const& host, ConnectionPtr connection);
+
+    ssl_stream makeStream(net::any_io_executor const& executor);
+    // resolve, connect and handshake, recording the time of each into `timing`
+    Task<Result<void>> connect(ssl_stream& stream, std::string const& host, RequestTiming& timing);
+    // gracefully close the stream, errors of a peer that just drops the connection are ignored
+    Task<beast::error_code> shutdown(ssl_stream& stream);
+    bool recording() const {
+        return _archive && _archive->mode() == TrafficArchive::Mode::Record;
+    }
+    // answer from `_archive` after the recorded time, `Error::Data` if the request is unknown
+    Task<ResponseResult> replayReply(std::string const& key);
+    Task<DownloadResult> replayDownload(std::string const& key,
+                                        std::filesystem::path path,
+                                        DownloadProgress progress);
+    // replace a compressed body with its decoded content
+    Result<void> decodeBody(http::response<http::dynamic_body>& res);
+
     net::ssl::context _ctx;
-    std::chrono::seconds _timeout; // respective timeout of ssl handshake & http
+    // loading the CA store takes a while, it is done by the first connection
+    std::once_flag _verifyPathsLoaded;
+    std::chrono::seconds _timeout; // ceiling of the deadline of every phase
+    LatencyTracker _latency;       // derives the actual deadlines per host
+    TransferStats _stats;
+    CircuitBreaker _circuitBreaker;
+    std::mt19937 _random{std::random_device{}()};
+    std::unordered_map<std::string, std::vector<ConnectionPtr>> _idle; // most recent last
+    std::unordered_set<std::string> _warmingUp;
+    std::unique_ptr<TrafficArchive> _archive;
 };
 
-} // namespace evento
\ No newline at end of file
+} // namespace evento
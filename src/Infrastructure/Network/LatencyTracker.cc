@@ -0,0 +1,96 @@
+#include <Infrastructure/Network/LatencyTracker.h>
+#include <algorithm>
+#include <vector>
+
+namespace evento {
+
+using std::chrono::milliseconds;
+
+namespace {
+
+// never tighter than these, so that a fast history does not turn a hiccup into a failure
+constexpr milliseconds MIN_CONNECT_DEADLINE{2000};
+constexpr milliseconds MIN_READ_DEADLINE{3000};
+
+} // namespace
+
+void LatencyTracker::recordRtt(std::string const& host, std::chrono::steady_clock::duration rtt) {
+    auto sample = std::chrono::duration_cast<milliseconds>(rtt);
+    auto& stats = _hosts[host];
+    if (!stats.srtt) {
+        stats.srtt = sample;
+        stats.rttvar = sample / 2;
+        return;
+    }
+    // alpha = 1/8, beta = 1/4
+    auto delta = sample > *stats.srtt ? sample - *stats.srtt : *stats.srtt - sample;
+    stats.rttvar = (stats.rttvar * 3 + delta) / 4;
+    stats.srtt = (*stats.srtt * 7 + sample) / 8;
+}
+
+void LatencyTracker::recordLatency(std::string const& host,
+                                   std::chrono::steady_clock::duration latency) {
+    auto sample = std::chrono::duration_cast<milliseconds>(latency);
+    auto& stats = _hosts[host];
+    stats.latencyEwma = stats.latencyEwma ? (*stats.latencyEwma * 7 + sample) / 8 : sample;
+    stats.window[stats.samples % WINDOW_SIZE] = sample;
+    ++stats.samples;
+}
+
+milliseconds LatencyTracker::percentile(HostStats const& stats, double ratio) {
+    auto count = std::min(stats.samples, WINDOW_SIZE);
+    if (count == 0) {
+        return milliseconds(0);
+    }
+    std::vector<milliseconds> sorted(stats.window.begin(), stats.window.begin() + count);
+    auto nth = sorted.begin() + static_cast<std::ptrdiff_t>((count - 1) * ratio);
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    return *nth;
+}
+
+PhaseDeadlines LatencyTracker::deadlines(std::string const& host) const {
+    PhaseDeadlines deadlines{_ceiling, _ceiling, _ceiling, _ceiling};
+    auto it = _hosts.find(host);
+    if (it == _hosts.end()) {
+        return deadlines;
+    }
+    auto const& stats = it->second;
+
+    if (stats.srtt) {
+        // retransmission timeout, with room for a lost SYN or handshake flight
+        auto rto = *stats.srtt + 4 * stats.rttvar;
+        deadlines.connect = std::clamp(3 * rto, MIN_CONNECT_DEADLINE, _ceiling);
+        deadlines.handshake = std::clamp(4 * rto, MIN_CONNECT_DEADLINE, _ceiling);
+        deadlines.write = std::clamp(3 * rto, MIN_CONNECT_DEADLINE, _ceiling);
+    }
+    if (stats.samples >= MIN_HEDGE_SAMPLES) {
+        deadlines.read = std::clamp(4 * percentile(stats, 0.95), MIN_READ_DEADLINE, _ceiling);
+    }
+    return deadlines;
+}
+
+std::optional<milliseconds> LatencyTracker::hedgeDelay(std::string const& host) const {
+    auto it = _hosts.find(host);
+    if (it == _hosts.end() || it->second.samples < MIN_HEDGE_SAMPLES) {
+        return std::nullopt;
+    }
+    return percentile(it->second, 0.95);
+}
+
+std::optional<LatencyTracker::Estimate> LatencyTracker::estimate(std::string const& host) const {
+    auto it = _hosts.find(host);
+    if (it == _hosts.end()) {
+        return std::nullopt;
+    }
+    auto const& stats = it->second;
+    return Estimate{
+        .srtt = stats.srtt.value_or(milliseconds(0)),
+        .rttvar = stats.rttvar,
+        .latencyEwma = stats.latencyEwma.value_or(milliseconds(0)),
+        .p50 = percentile(stats, 0.5),
+        .p95 = percentile(stats, 0.95),
+        .samples = std::min(stats.samples, WINDOW_SIZE),
+    };
+}
+
+} // namespace evento
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace evento {
+
+// deadlines of the phases of one request
+struct PhaseDeadlines {
+    std::chrono::milliseconds connect;
+    std::chrono::milliseconds handshake;
+    std::chrono::milliseconds write;
+    std::chrono::milliseconds read; // from request sent until response read, or between chunks
+};
+
+// Per-host estimates of round-trip time and request latency, used to derive deadlines.
+// RTT is smoothed like TCP does (RFC 6298), latency keeps an EWMA and a window of recent
+// samples for percentiles. Hosts without samples get `ceiling` for every phase.
+class LatencyTracker {
+public:
+    struct Estimate {
+        std::chrono::milliseconds srtt;
+        std::chrono::milliseconds rttvar;
+        std::chrono::milliseconds latencyEwma;
+        std::chrono::milliseconds p50;
+        std::chrono::milliseconds p95;
+        std::size_t samples; // latency samples in the window
+    };
+
+    explicit LatencyTracker(std::chrono::milliseconds ceiling)
+        : _ceiling(ceiling) {}
+
+    // time of the TCP connect, roughly one round trip
+    void recordRtt(std::string const& host, std::chrono::steady_clock::duration rtt);
+    // time from writing the request until the response is read
+    void recordLatency(std::string const& host, std::chrono::steady_clock::duration latency);
+
+    [[nodiscard]] PhaseDeadlines deadlines(std::string const& host) const;
+    // p95 of the latency, once there are enough samples to trust it
+    [[nodiscard]] std::optional<std::chrono::milliseconds> hedgeDelay(
+        std::string const& host) const;
+    [[nodiscard]] std::optional<Estimate> estimate(std::string const& host) const;
+
+    static constexpr std::size_t WINDOW_SIZE = 64;
+    static constexpr std::size_t MIN_HEDGE_SAMPLES = 16;
+
+private:
+    struct HostStats {
+        std::optional<std::chrono::milliseconds> srtt;
+        std::chrono::milliseconds rttvar{0};
+        std::optional<std::chrono::milliseconds> latencyEwma;
+        std::array<std::chrono::milliseconds, WINDOW_SIZE> window{};
+        std::size_t samples = 0; // total, the window holds the last `WINDOW_SIZE`
+    };
+
+    static std::chrono::milliseconds percentile(HostStats const& stats, double ratio);
+
+    std::chrono::milliseconds _ceiling;
+    std::unordered_map<std::string, HostStats> _hosts;
+};
+
+} // namespace evento
@@ -1,24 +1,63 @@
+#include <Infrastructure/Cache/PixelCache.h>
 #include <Infrastructure/Network/Api/Evento.hh>
 #include <Infrastructure/Network/Api/Github.hh>
 #include <Infrastructure/Network/NetworkClient.h>
 #include <Infrastructure/Network/ResponseStruct.h>
+#include <Infrastructure/Utils/Diagnostics.h>
 #include <Infrastructure/Utils/Tools.h>
+#include <algorithm>
 #include <array>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <cstdlib>
+#include <random>
 #if defined(PLATFORM_APPLE)
 #include <fstream>
 #endif
 
 namespace evento {
 
-static const std::string EVENTO_API_GATEWAY = "https://evento.sast.fun/api";
-static const std::string GITHUB_API_GATEWAY = "https://api.github.com/repos";
+// `fallback` unless overridden by `variable` from the environment,
+// e.g. "https://127.0.0.1:8443/api" to run against `sast-evento-mock`.
+// Debug and bench builds only, the access token goes to whatever host the gateway names.
+static std::string gatewayOf(const char* variable, const char* fallback) {
+#if defined(EVENTO_DEBUG) || defined(EVENTO_GATEWAY_OVERRIDE)
+    if (auto gateway = std::getenv(variable); gateway && *gateway) {
+        spdlog::warn("{} overrides the gateway: {}", variable, gateway);
+        return gateway;
+    }
+#endif
+    return fallback;
+}
+
+static std::string const& eventoGateway() {
+    static std::string const s_gateway = gatewayOf("EVENTO_API_GATEWAY",
+                                                   "https://evento.sast.fun/api");
+    return s_gateway;
+}
+
+static std::string const& githubGateway() {
+    static std::string const s_gateway = gatewayOf("EVENTO_GITHUB_GATEWAY",
+                                                   "https://api.github.com/repos");
+    return s_gateway;
+}
 
 constexpr const char MIME_JSON[] = "application/json";
 constexpr const char MIME_FORM_URL_ENCODED[] = "application/x-www-form-urlencoded";
 
 NetworkClient::NetworkClient()
     : _httpsAccessManager(std::make_unique<HttpsAccessManager>(true))
-    , _cacheManager(std::make_unique<CacheManager>()) {}
+    , _cacheManager(std::make_unique<CacheManager>())
+    , _downloadManager(std::make_unique<DownloadManager>())
+    , _connectivity(std::make_unique<ConnectivityMonitor>()) {
+    if (auto archive = TrafficArchive::fromEnvironment()) {
+        _httpsAccessManager->setTrafficArchive(std::move(archive));
+    }
+    if (auto hedging = std::getenv("EVENTO_HEDGING"); hedging && std::string_view(hedging) == "1") {
+        _httpsAccessManager->hedging = true;
+    }
+    diagnostics()->add("network", [this] { return _metrics.dump(); });
+    diagnostics()->add("cache", [this] { return _cacheManager->dump(); });
+}
 
 NetworkClient* NetworkClient::getInstance() {
     static NetworkClient s_instance;
@@ -71,6 +110,18 @@ static EventQueryRes eventEntityListV1ToV2(std::vector<EventEntityV1> const& lis
         .total = total,
     };
 }
+
+// list endpoints asked for `page` and `size` answer with every event, or with a page
+// `{"elements": [...], "current": page, "total": n}` if the backend pages, e.g. the mock one
+static EventQueryRes eventPageV1ToV2(nlohmann::basic_json<> const& data) {
+    if (!data.is_object()) {
+        return eventEntityListV1ToV2(data.get<std::vector<EventEntityV1>>());
+    }
+    auto page = eventEntityListV1ToV2(data.at("elements").get<std::vector<EventEntityV1>>());
+    page.current = data.at("current").get<int>();
+    page.total = data.at("total").get<int>();
+    return page;
+}
 #endif
 
 Task<Result<LoginResEntity>> NetworkClient::loginViaSastLink(std::string code) {
@@ -152,14 +203,17 @@ Task<Result<void>> NetworkClient::refreshAccessToken(std::string refreshToken) {
 }
 
 Task<Result<EventQueryRes>> NetworkClient::getActiveEventList(
-    std::chrono::steady_clock::duration cacheTtl) {
+    std::chrono::steady_clock::duration cacheTtl, ResponseFingerprint* fingerprint) {
 #ifdef EVENTO_API_V1
     auto result = co_await this->request<api::Evento>(http::verb::get,
                                                       endpoint("/event/conducting"),
                                                       {},
-                                                      cacheTtl);
+                                                      cacheTtl,
+                                                      fingerprint);
     if (result.isErr())
         co_return Err(result.unwrapErr());
+    if (fingerprint && fingerprint->unchanged())
+        co_return Ok(EventQueryRes{});
 
     std::vector<EventEntityV1> list;
     try {
@@ -174,9 +228,12 @@ Task<Result<EventQueryRes>> NetworkClient::getActiveEventList(
                                                       endpoint("/v2/client/event/query",
                                                                {{"active", "true"}}),
                                                       {},
-                                                      cacheTtl);
+                                                      cacheTtl,
+                                                      fingerprint);
     if (result.isErr())
         co_return Err(result.unwrapErr());
+    if (fingerprint && fingerprint->unchanged())
+        co_return Ok(EventQueryRes{});
 
     EventQueryRes entity;
     try {
@@ -190,7 +247,7 @@ Task<Result<EventQueryRes>> NetworkClient::getActiveEventList(
 }
 
 Task<Result<EventQueryRes>> NetworkClient::getLatestEventList(
-    std::chrono::steady_clock::duration cacheTtl) {
+    std::chrono::steady_clock::duration cacheTtl, ResponseFingerprint* fingerprint) {
 #ifdef EVENTO_API_V1
     auto result = co_await this->request<api::Evento>(http::verb::post,
                                                       endpoint("/event/list",
@@ -198,9 +255,12 @@ Task<Result<EventQueryRes>> NetworkClient::getLatestEventList(
                                                                 {"typeId", ""},
                                                                 {"time", firstDateTimeOfWeek()}}),
                                                       {},
-                                                      cacheTtl);
+                                                      cacheTtl,
+                                                      fingerprint);
     if (result.isErr())
         co_return Err(result.unwrapErr());
+    if (fingerprint && fingerprint->unchanged())
+        co_return Ok(EventQueryRes{});
 
     std::vector<EventEntityV1> list;
     try {
@@ -215,9 +275,12 @@ Task<Result<EventQueryRes>> NetworkClient::getLatestEventList(
                                                       endpoint("/v2/client/event/query",
                                                                {{"start", "now"}}),
                                                       {},
-                                                      cacheTtl);
+                                                      cacheTtl,
+                                                      fingerprint);
     if (result.isErr())
         co_return Err(result.unwrapErr());
+    if (fingerprint && fingerprint->unchanged())
+        co_return Ok(EventQueryRes{});
 
     EventQueryRes entity;
     try {
@@ -234,20 +297,19 @@ Task<Result<EventQueryRes>> NetworkClient::getHistoryEventList(
     int page, int size, std::chrono::steady_clock::duration cacheTtl) {
 #ifdef EVENTO_API_V1
     auto result = co_await this->request<api::Evento>(http::verb::get,
-                                                      endpoint("/event/history"),
+                                                      endpoint("/event/history",
+                                                               {{"page", std::to_string(page)},
+                                                                {"size", std::to_string(size)}}),
                                                       {},
                                                       cacheTtl);
     if (result.isErr())
         co_return Err(result.unwrapErr());
 
-    std::vector<EventEntityV1> list;
     try {
-        nlohmann::from_json(result.unwrap(), list);
+        co_return Ok(eventPageV1ToV2(result.unwrap()));
     } catch (const nlohmann::json::exception& e) {
         co_return Err(Error(Error::JsonDes, e.what()));
     }
-
-    co_return Ok(eventEntityListV1ToV2(list));
 #else
     auto result = co_await this->request<api::Evento>(http::verb::get,
                                                       endpoint("/v2/client/event/query",
@@ -282,18 +344,17 @@ Task<Result<EventQueryRes>> NetworkClient::getDepartmentEventList(
         endpoint("/event/list",
                  {{"departmentId", std::to_string(departmentIdMap[larkDepartment])},
                   {"typeId", ""},
-                  {"time", "1970-01-01"}}));
+                  {"time", "1970-01-01"},
+                  {"page", std::to_string(page)},
+                  {"size", std::to_string(size)}}));
     if (result.isErr())
         co_return Err(result.unwrapErr());
 
-    std::vector<EventEntityV1> list;
     try {
-        nlohmann::from_json(result.unwrap(), list);
+        co_return Ok(eventPageV1ToV2(result.unwrap()));
     } catch (const nlohmann::json::exception& e) {
         co_return Err(Error(Error::JsonDes, e.what()));
     }
-
-    co_return Ok(eventEntityListV1ToV2(list));
 #else
     auto result = co_await this->request<api::Evento>(http::verb::get,
                                                       endpoint("/v2/client/event/query",
@@ -612,7 +673,7 @@ Task<Result<EventQueryRes>> NetworkClient::getParticipatedEvent(
 }
 
 Task<Result<EventQueryRes>> NetworkClient::getSubscribedEvent(
-    std::chrono::steady_clock::duration cacheTtl) {
+    std::chrono::steady_clock::duration cacheTtl, ResponseFingerprint* fingerprint) {
 #ifdef EVENTO_API_V1
     auto result = co_await this->request<api::Evento>(http::verb::get,
                                                       endpoint("/user/subscribed"),
@@ -648,9 +709,12 @@ Task<Result<EventQueryRes>> NetworkClient::getSubscribedEvent(
                                                                {{"isSubscribed", "true"},
                                                                 {"start", startTime}}),
                                                       {},
-                                                      cacheTtl);
+                                                      cacheTtl,
+                                                      fingerprint);
     if (result.isErr())
         co_return Err(result.unwrapErr());
+    if (fingerprint && fingerprint->unchanged())
+        co_return Ok(EventQueryRes{});
 
     EventQueryRes entity;
     try {
@@ -784,12 +848,12 @@ Task<Result<DepartmentEntityList>> NetworkClient::getDepartmentList(
 }
 
 urls::url NetworkClient::endpoint(std::string_view endpoint) {
-    return urls::url(EVENTO_API_GATEWAY + endpoint.data());
+    return urls::url(eventoGateway() + endpoint.data());
 }
 
 urls::url NetworkClient::endpoint(std::string_view endpoint,
                                   std::initializer_list<urls::param> const& params) {
-    auto r = urls::url(EVENTO_API_GATEWAY + endpoint.data());
+    auto r = urls::url(eventoGateway() + endpoint.data());
     r.params().append(params.begin(), params.end());
     return r;
 }
@@ -830,26 +894,19 @@ Task<Result<ReleaseEntity>> NetworkClient::getLatestRelease() {
 
 Task<Result<std::filesystem::path>> NetworkClient::getFile(std::string urlStr,
                                                            std::optional<std::filesystem::path> dir,
-                                                           bool useCache) {
+                                                           bool useCache,
+                                                           DownloadPriority priority,
+                                                           DownloadProgress progress) {
     if (urlStr.ends_with('\\')) {
         urlStr.pop_back();
     }
-    spdlog::debug("Downloading file: {}", urlStr);
-    auto url = urls::url(urlStr);
-    http::request<http::string_body> req{http::verb::get,
-                                         std::format("{}{}{}",
-                                                     url.encoded_path().data(),
-                                                     url.has_query() ? "?" : "",
-                                                     url.encoded_query().data()),
-                                         11};
 
     if (!dir) {
         co_return Err(Error(Error::Data, "directory not found"));
     }
 
-    auto stem = CacheManager::generateStem(urlStr);
-
     if (useCache) {
+        auto stem = CacheManager::generateStem(urlStr);
         std::filesystem::directory_iterator iter(*dir);
         for (const auto& file : iter) {
             if (file.path().filename().stem().string() == stem) {
@@ -858,18 +915,71 @@ Task<Result<std::filesystem::path>> NetworkClient::getFile(std::string urlStr,
         }
     }
 
-    req.set(http::field::host, url.host_name());
+    if (_connectivity->offline()) {
+        co_return Err(Error(Error::Network, OFFLINE_REASON));
+    }
+
+    co_return co_await _downloadManager->download(
+        urlStr,
+        priority,
+        std::move(progress),
+        [this, dir = *dir](std::string url, DownloadProgress progress) {
+            return fetchFile(std::move(url), dir, std::move(progress));
+        });
+}
+
+Task<void> NetworkClient::cancelDownload(std::string url) {
+    _downloadManager->cancel(url);
+    co_return;
+}
+
+Task<void> NetworkClient::cancelDownloads(DownloadPriority priority) {
+    _downloadManager->cancel(priority);
+    co_return;
+}
+
+Task<Result<std::filesystem::path>> NetworkClient::fetchFile(std::string urlStr,
+                                                             std::filesystem::path dir,
+                                                             DownloadProgress progress) {
+    spdlog::debug("Downloading file: {}", urlStr);
+    auto url = urls::url(urlStr);
+    http::request<http::string_body> req{http::verb::get,
+                                         std::format("{}{}{}",
+                                                     url.encoded_path().data(),
+                                                     url.has_query() ? "?" : "",
+                                                     url.encoded_query().data()),
+                                         11};
+
+    auto stem = CacheManager::generateStem(urlStr);
+
+    auto host = std::string(url.encoded_host_and_port());
+    req.set(http::field::host, host);
     req.set(http::field::user_agent, "SAST-Evento-Desktop/2");
     req.set(http::field::accept, "*/*");
 
+    // bodies are streamed into `partial/` first, and only moved next to the cache once complete
+    std::error_code ec;
+    auto partialDir = dir / "partial";
+    std::filesystem::create_directories(partialDir, ec);
+    auto partialPath = partialDir / stem;
+
     // if cache not exists, download file
-    auto reply = co_await _httpsAccessManager->makeReply(url.host(), req);
+    RequestTiming timing;
+    auto reply = co_await _httpsAccessManager->makeDownload(host,
+                                                            req,
+                                                            partialPath,
+                                                            std::move(progress),
+                                                            &timing);
+    recordConnectivity(reply);
+    // file urls are unique, aggregate them per host
+    recordTiming(NetworkMetrics::endpointOf("DOWNLOAD", std::string(url.host()), ""), timing);
     if (reply.isErr())
         co_return Err(reply.unwrapErr());
 
     auto response = reply.unwrap();
 
-    if (response.result() != http::status::ok) {
+    if (response.result() != http::status::ok
+        && response.result() != http::status::partial_content) {
         co_return Err(Error(Error::Network, std::to_string(response.result_int())));
     }
 
@@ -878,32 +988,308 @@ Task<Result<std::filesystem::path>> NetworkClient::getFile(std::string urlStr,
         co_return Err(Error(Error::Data, "file type error"));
     }
 
-    auto data = beast::buffers_to_string(response.body().data());
-    if (data.length() < 4) { // magic number length
-        co_return Err(Error(Error::Data, "file data error"));
+    std::array<unsigned char, 4> magic{}; // magic number
+    {
+        std::ifstream file(partialPath, std::ios::binary);
+        file.read(reinterpret_cast<char*>(magic.data()), magic.size());
+        if (file.gcount() < static_cast<std::streamsize>(magic.size())) {
+            std::filesystem::remove(partialPath, ec);
+            co_return Err(Error(Error::Data, "file data error"));
+        }
     }
 
     auto value = type->value();
     stem += '.';
     if (value.substr(0, value.find('/')) == "image") {
-        auto ext = guessImageExtByBytes(std::array<unsigned char, 4>{(unsigned char) data[0],
-                                                                     (unsigned char) data[1],
-                                                                     (unsigned char) data[2],
-                                                                     (unsigned char) data[3]});
+        auto ext = guessImageExtByBytes(magic);
         spdlog::debug("Guess image ext: {}", ext);
         stem += ext;
     } else {
         stem += value.substr(value.find('/') + 1);
     }
-    auto path = *dir / stem;
+    auto path = dir / stem;
 
-    if (!co_await saveToDisk(data, path)) {
+    std::filesystem::rename(partialPath, path, ec);
+    if (ec) {
+        spdlog::warn("Failed to save file: {}", ec.message());
         co_return Err(Error(Error::Data, "save file failed"));
     }
     co_return Ok(path);
 }
 
+Task<void> NetworkClient::watchConnectivity(ConnectivityMonitor::Listener listener) {
+    // a replay needs no network, whatever the OS says
+    if (_httpsAccessManager->replaying()) {
+        co_return;
+    }
+    co_await _connectivity->watch(std::move(listener));
+}
+
+Task<void> NetworkClient::warmUpEvento() {
+    if (!_connectivity->offline()) {
+        co_await _httpsAccessManager->warmUp(hostOf(endpoint("")));
+    }
+}
+
+Task<void> NetworkClient::warmUpGithub() {
+    if (!_connectivity->offline()) {
+        co_await _httpsAccessManager->warmUp(hostOf(githubEndpoint("")));
+    }
+}
+
+namespace {
+
+// whether `event` belongs into the list cached under `key` as far as the flags of the user
+// go, see `mayMatchTimeFilters` for the state and time
+bool matchesUserFilters(std::string_view key, EventEntity const& event) {
+    if (key.find("isSubscribed=true") != std::string_view::npos && !event.isSubscribed) {
+        return false;
+    }
+    if (key.find("isCheckedIn=true") != std::string_view::npos && !event.isCheckedIn) {
+        return false;
+    }
+    return true;
+}
+
+bool filtersByUser(std::string_view key) {
+    return key.find("isSubscribed=true") != std::string_view::npos
+           || key.find("isCheckedIn=true") != std::string_view::npos;
+}
+
+// the value of the query parameter `name` of the url in `key`, if it has one
+std::optional<std::string_view> paramOf(std::string_view key, std::string_view name) {
+    key = key.substr(0, key.find('|'));
+    for (auto pos = key.find(name); pos != std::string_view::npos; pos = key.find(name, pos + 1)) {
+        auto end = pos + name.size();
+        if (pos > 0 && (key[pos - 1] == '?' || key[pos - 1] == '&') && end < key.size()
+            && key[end] == '=') {
+            auto value = key.substr(end + 1);
+            return value.substr(0, value.find('&'));
+        }
+    }
+    return std::nullopt;
+}
+
+// whether the list cached under `key` filters by the state or the time of its events
+bool filtersByTime(std::string_view key) {
+    return paramOf(key, "active") || paramOf(key, "start") || paramOf(key, "end");
+}
+
+// whether `event` may belong into the list cached under `key` as far as its state and time
+// go, by the clock of the client; a bound other than "now" is left to the backend
+bool mayMatchTimeFilters(std::string_view key, EventEntity const& event) {
+    auto now = std::chrono::system_clock::now();
+    auto timeOf = [](std::string const& time) {
+        auto parsed = parseIso8601Utc(time.c_str());
+        return parsed == -1 ? std::nullopt
+                            : std::optional(std::chrono::system_clock::from_time_t(parsed));
+    };
+    if (paramOf(key, "active") == "true" && event.state != State::Active) {
+        return false;
+    }
+    if (paramOf(key, "start") == "now") {
+        if (auto start = timeOf(event.start); start && *start < now) {
+            return false;
+        }
+    }
+    if (paramOf(key, "end") == "now") {
+        if (auto end = timeOf(event.end); end && *end > now) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool timeChanged(nlohmann::basic_json<> const& cached, nlohmann::basic_json<> const& updated) {
+    return std::ranges::any_of(std::array{"state", "start", "end"}, [&](auto field) {
+        return cached.value(field, nlohmann::json()) != updated.value(field, nlohmann::json());
+    });
+}
+
+} // namespace
+
+Task<void> NetworkClient::watchChanges(ChangeListener listener) {
+    using namespace net::experimental::awaitable_operators;
+#ifdef EVENTO_API_V1
+    setPushState(PushState::Unavailable, listener);
+    co_return;
+#else
+    if (_httpsAccessManager->replaying()) {
+        setPushState(PushState::Unavailable, listener);
+        co_return;
+    }
+
+    auto executor = co_await net::this_coro::executor;
+    _changesRestart.emplace(executor, std::chrono::steady_clock::time_point::max());
+    auto restarted = [this]() -> Task<void> {
+        co_await _changesRestart->async_wait(net::as_tuple(net::use_awaitable));
+    };
+
+    std::mt19937 random(std::random_device{}());
+    std::chrono::steady_clock::duration backoff = CHANGES_RETRY_MIN;
+    while (true) {
+        std::chrono::steady_clock::duration wait = ConnectivityMonitor::PROBE_INTERVAL;
+        if (!_connectivity->offline()) {
+            auto start = std::chrono::steady_clock::now();
+            auto outcome = co_await (streamChanges(listener) || restarted());
+            if (outcome.index() == 1) {
+                setPushState(PushState::Disconnected, listener);
+                backoff = CHANGES_RETRY_MIN;
+                continue;
+            }
+            auto result = std::get<0>(std::move(outcome));
+            if (result.isOk() && result.unwrap() != http::status::ok) {
+                spdlog::info("No change feed ({}), polling", static_cast<int>(result.unwrap()));
+                setPushState(PushState::Unavailable, listener);
+                wait = CHANGES_UNAVAILABLE_RETRY;
+                backoff = CHANGES_RETRY_MIN;
+            } else {
+                if (result.isErr()) {
+                    spdlog::debug("Change feed dropped: {}", result.unwrapErr().what());
+                }
+                setPushState(PushState::Disconnected, listener);
+                if (std::chrono::steady_clock::now() - start > CHANGES_STABLE) {
+                    backoff = CHANGES_RETRY_MIN;
+                }
+                // full jitter, so that clients dropped together do not come back together
+                wait = std::chrono::milliseconds(std::uniform_int_distribution<long long>(
+                    0,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(backoff).count())(
+                    random));
+                backoff = std::min<std::chrono::steady_clock::duration>(backoff * 2,
+                                                                        CHANGES_RETRY_MAX);
+            }
+        }
+
+        // `reconnectChanges` cuts the wait short
+        net::steady_timer timer(executor, wait);
+        co_await (timer.async_wait(net::use_awaitable) || restarted());
+    }
+#endif
+}
+
+Task<void> NetworkClient::reconnectChanges() {
+    if (_changesRestart) {
+        // wakes whoever waits for it, the expiry stays in the far future
+        _changesRestart->cancel();
+    }
+    co_return;
+}
+
+Task<Result<http::status>> NetworkClient::streamChanges(ChangeListener const& listener) {
+    auto url = endpoint("/v2/client/event/changes");
+    auto req = api::Evento::makeRequest(http::verb::get, url, tokenBytes);
+    if (!_lastChangeId.empty()) {
+        req.set("Last-Event-ID", _lastChangeId);
+    }
+    bool opened = false;
+    auto result = co_await _httpsAccessManager->makeEventStream(
+        hostOf(url),
+        std::move(req),
+        {.opened =
+             [this, &listener, &opened] {
+                 opened = true;
+                 _connectivity->recordSuccess();
+                 setPushState(PushState::Connected, listener);
+             },
+         .event = [this, &listener](ServerSentEvent event) { onChangeEvent(event, listener); }});
+    // an open stream going quiet past its idle timeout, or dropped, is no connection failure
+    if (!opened) {
+        recordConnectivity(result);
+    }
+    if (result.isErr()) {
+        co_return Err(result.unwrapErr());
+    }
+    co_return Ok(result.unwrap().result());
+}
+
+void NetworkClient::onChangeEvent(ServerSentEvent const& event, ChangeListener const& listener) {
+    _lastChangeId = event.id;
+    EventChange change{};
+    try {
+        auto data = nlohmann::json::parse(event.data);
+        if (event.type == "event") {
+            change.event = data.get<EventEntity>();
+            change.id = change.event->id;
+        } else if (event.type == "deleted") {
+            change.id = data.at("id").get<int>();
+        } else {
+            // unknown to this version
+            return;
+        }
+    } catch (nlohmann::json::exception const& e) {
+        spdlog::warn("Ignoring change {}: {}", event.id, e.what());
+        return;
+    }
+
+    auto patched = applyChange(change);
+    spdlog::debug("Change of event {} pushed, {} cache entries patched", change.id, patched);
+    if (listener.change) {
+        listener.change(change);
+    }
+}
+
+std::size_t NetworkClient::applyChange(EventChange const& change) {
+    auto updated = change.event ? nlohmann::json(*change.event) : nlohmann::json();
+    return _cacheManager->patch([&](std::string const& key, nlohmann::basic_json<>& data) {
+        // `EventQueryRes` of API v2
+        if (!data.is_object() || !data.contains("elements") || !data["elements"].is_array()) {
+            return CachePatch::Unchanged;
+        }
+        auto& elements = data["elements"];
+        auto it = std::find_if(elements.begin(), elements.end(), [&](auto const& element) {
+            return element.is_object() && element.value("id", 0) == change.id;
+        });
+        auto belongs = change.event && matchesUserFilters(key, *change.event)
+                       && mayMatchTimeFilters(key, *change.event);
+        if (it == elements.end()) {
+            // joined a list of the user or entered a state or time window, where it goes in
+            // the pages is up to the backend
+            return belongs && (filtersByUser(key) || filtersByTime(key)) ? CachePatch::Invalidated
+                                                                         : CachePatch::Unchanged;
+        }
+        if (!belongs) {
+            elements.erase(it);
+            if (data.contains("total") && data["total"].is_number_integer()) {
+                data["total"] = data["total"].get<int>() - 1;
+            }
+            return CachePatch::Updated;
+        }
+        if (*it == updated) {
+            return CachePatch::Unchanged;
+        }
+        if (filtersByTime(key) && timeChanged(*it, updated)) {
+            // may have left the list, or moved within it
+            return CachePatch::Invalidated;
+        }
+        *it = updated;
+        return CachePatch::Updated;
+    });
+}
+
+void NetworkClient::setPushState(PushState state, ChangeListener const& listener) {
+    if (_pushState.exchange(state) != state && listener.state) {
+        listener.state(state);
+    }
+}
+
+std::string NetworkClient::hostOf(urls::url_view url) {
+    return std::string(url.encoded_host_and_port());
+}
+
+std::string NetworkClient::metricsKeyOf(http::verb verb, urls::url_view url) {
+    return NetworkMetrics::endpointOf(std::string(http::to_string(verb)),
+                                      std::string(url.host()),
+                                      std::string(url.encoded_path()));
+}
+
+void NetworkClient::recordTiming(std::string const& metricsKey, RequestTiming const& timing) {
+    spdlog::debug("{}: {}", metricsKey, timing.summary());
+    _metrics.record(metricsKey, timing);
+}
+
 void NetworkClient::clearCache() {
+    pixelCache()->clear();
     _cacheManager->clear();
 }
 
@@ -911,12 +1297,53 @@ void NetworkClient::clearMemoryCache() {
     _cacheManager->clearMemoryCache();
 }
 
-std::string NetworkClient::getTotalCacheSizeFormatString() {
-    if (auto dir = _cacheManager->cacheDir()) {
-        std::uintmax_t size = 0;
-        for (const auto& file : std::filesystem::directory_iterator(*dir)) {
-            size += file.file_size();
+NetworkClient::DiskCacheUsage NetworkClient::diskCacheUsage() {
+    DiskCacheUsage usage;
+    if (auto dir = CacheManager::cacheDir()) {
+        // includes the pre-decoded pixels living in sub-directories
+        for (const auto& file : std::filesystem::recursive_directory_iterator(*dir)) {
+            if (file.is_regular_file()) {
+                ++usage.files;
+                usage.bytes += file.file_size();
+            }
         }
+    }
+    return usage;
+}
+
+NetworkClient::DiskCacheUsage NetworkClient::collectGarbage(std::chrono::hours maxAge) {
+    DiskCacheUsage removed;
+    auto dir = CacheManager::cacheDir();
+    if (!dir) {
+        return removed;
+    }
+    auto now = std::filesystem::file_time_type::clock::now();
+    auto collect = [&](std::filesystem::path const& from, bool withPixels) {
+        std::error_code ec;
+        for (auto const& file : std::filesystem::directory_iterator(from, ec)) {
+            if (!file.is_regular_file(ec) || now - file.last_write_time(ec) < maxAge) {
+                continue;
+            }
+            auto size = file.file_size(ec);
+            if (std::filesystem::remove(file.path(), ec)) {
+                ++removed.files;
+                removed.bytes += size;
+                if (withPixels) {
+                    pixelCache()->remove(file.path());
+                }
+            }
+        }
+    };
+    collect(*dir, true);
+    // `<stem>` and `<stem>.meta` of downloads that were never resumed
+    collect(*dir / "partial", false);
+    spdlog::info("Cache garbage collected: {} files, {} bytes", removed.files, removed.bytes);
+    return removed;
+}
+
+std::string NetworkClient::getTotalCacheSizeFormatString() {
+    if (CacheManager::cacheDir()) {
+        auto size = diskCacheUsage().bytes;
 
         if (size < 1024) {
             return std::format("{}B", size);
@@ -933,16 +1360,34 @@ std::string NetworkClient::getTotalCacheSizeFormatString() {
 }
 
 urls::url NetworkClient::githubEndpoint(std::string_view endpoint) {
-    return urls::url(GITHUB_API_GATEWAY + endpoint.data());
+    return urls::url(githubGateway() + endpoint.data());
 }
 
 urls::url NetworkClient::githubEndpoint(std::string_view endpoint,
                                         std::initializer_list<urls::param> const& params) {
-    auto r = urls::url(GITHUB_API_GATEWAY + endpoint.data());
+    auto r = urls::url(githubGateway() + endpoint.data());
     r.params().append(params.begin(), params.end());
     return r;
 }
 
+JsonResult NetworkClient::delivered(CacheEntry entry, ResponseFingerprint* fingerprint) {
+    if (fingerprint) {
+        fingerprint->delivered = entry.fingerprint;
+        if (fingerprint->unchanged()) {
+            return Ok(nlohmann::basic_json<>());
+        }
+    }
+    return Ok(std::move(entry.data));
+}
+
+Fingerprint NetworkClient::fingerprintBody(http::dynamic_body::value_type const& body) {
+    Fingerprinter fingerprinter;
+    for (auto buffer : beast::buffers_range_ref(body.data())) {
+        fingerprinter.update({static_cast<char const*>(buffer.data()), buffer.size()});
+    }
+    return fingerprinter.digest();
+}
+
 JsonResult NetworkClient::handleEventoResponse(http::response<http::dynamic_body> response) {
     if (response.result() != http::status::ok) {
         return Err(Error(response.result_int()));
@@ -1009,52 +1454,6 @@ Task<JsonResult> NetworkClient::handleGithubResponse(http::response<http::dynami
     co_return Ok(res);
 }
 
-Task<bool> NetworkClient::saveToDisk(std::string const& data, std::filesystem::path const& path) {
-#if defined(PLATFORM_APPLE)
-
-    auto result = co_await net::co_spawn(
-        co_await net::this_coro::executor,
-        [data, path]() -> Task<bool> {
-            try {
-                std::ofstream file(path, std::ios::binary | std::ios::out | std::ios::trunc);
-                if (!file.is_open()) {
-                    spdlog::warn("Failed to open file: {}", path.string());
-                    co_return false;
-                }
-                file << data;
-                file.close();
-                co_return true;
-            } catch (std::exception const& e) {
-                spdlog::warn("Failed to save file: {}", e.what());
-                co_return false;
-            }
-        },
-        net::use_awaitable);
-    co_return result;
-
-#else
-
-    net::stream_file file(co_await net::this_coro::executor,
-                          path.string(),
-                          net::stream_file::write_only | net::stream_file::create);
-    if (!file.is_open()) {
-        co_return false;
-    }
-
-    auto totalSize = data.size();
-    std::size_t bytesWritten = 0;
-    while (bytesWritten < totalSize) {
-        bytesWritten += co_await file.async_write_some(net::buffer(data.data() + bytesWritten,
-                                                                   totalSize - bytesWritten),
-                                                       net::use_awaitable);
-    }
-
-    file.close();
-    co_return true;
-
-#endif
-}
-
 NetworkClient* networkClient() {
     return NetworkClient::getInstance();
 }
@@ -3,18 +3,26 @@
 #include <Infrastructure/Cache/Cache.h>
 #include <Infrastructure/Network/Api/Evento.hh>
 #include <Infrastructure/Network/Api/Github.hh>
+#include <Infrastructure/Network/ConnectivityMonitor.h>
+#include <Infrastructure/Network/DownloadManager.h>
 #include <Infrastructure/Network/HttpsAccessManager.h>
+#include <Infrastructure/Network/NetworkMetrics.h>
 #include <Infrastructure/Network/ResponseStruct.h>
 #include <Infrastructure/Utils/Debug.h>
+#include <Infrastructure/Utils/Fingerprint.h>
 #include <Infrastructure/Utils/Result.h>
+#include <atomic>
 #include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/url.hpp>
 #include <chrono>
 #include <concepts>
 #include <filesystem>
+#include <functional>
 #include <initializer_list>
 #include <memory>
+#include <optional>
 #include <spdlog/spdlog.h>
 #ifdef EVENTO_API_V1
 #include <unordered_map>
@@ -38,6 +46,24 @@ using Task = net::awaitable<T>;
 
 using namespace std::chrono_literals;
 
+// a change pushed by the backend, see `NetworkClient::watchChanges`
+struct EventChange {
+    int id;
+    // the event as it is now for the user of the token, empty if it was deleted
+    std::optional<EventEntity> event;
+};
+
+enum class PushState {
+    Disconnected, // connecting or waiting to reconnect
+    Connected,
+    Unavailable, // the backend has no change feed, it is asked again after a while
+};
+
+struct ChangeListener {
+    std::function<void(PushState)> state;
+    std::function<void(EventChange const&)> change;
+};
+
 class NetworkClient {
 public:
     NetworkClient(const NetworkClient&) = delete;
@@ -50,12 +76,15 @@ public:
     Task<Result<void>> refreshAccessToken(std::string refreshToken);
 
     // active: true
+    // `fingerprint` must outlive the call, see `ResponseFingerprint`, likewise below
     Task<Result<EventQueryRes>> getActiveEventList(
-        std::chrono::steady_clock::duration cacheTtl = 1min);
+        std::chrono::steady_clock::duration cacheTtl = 1min,
+        ResponseFingerprint* fingerprint = nullptr);
 
     // start: now
     Task<Result<EventQueryRes>> getLatestEventList(
-        std::chrono::steady_clock::duration cacheTtl = 1min);
+        std::chrono::steady_clock::duration cacheTtl = 1min,
+        ResponseFingerprint* fingerprint = nullptr);
 
     // end: now
     Task<Result<EventQueryRes>> getHistoryEventList(
@@ -96,8 +125,10 @@ public:
 
     // isSubscribed: true
     // start: first date of this week
+    // API v1 asks for the state of every event on top, the response is never unchanged
     Task<Result<EventQueryRes>> getSubscribedEvent(
-        std::chrono::steady_clock::duration cacheTtl = 1min);
+        std::chrono::steady_clock::duration cacheTtl = 1min,
+        ResponseFingerprint* fingerprint = nullptr);
 
     Task<Result<SlideEntityList>> getHomeSlide(std::chrono::steady_clock::duration cacheTtl = 1min);
 
@@ -111,15 +142,62 @@ public:
 
     Task<Result<ReleaseEntity>> getLatestRelease();
 
+    // downloads are scheduled by `DownloadManager`, see `DownloadPriority`
     Task<Result<std::filesystem::path>> getFile(
         std::string url,
         std::optional<std::filesystem::path> dir = CacheManager::cacheDir(),
-        bool useCache = true);
+        bool useCache = true,
+        DownloadPriority priority = DownloadPriority::Prefetch,
+        DownloadProgress progress = {});
+
+    // waiters of cancelled downloads get `Error::Cancelled`
+    Task<void> cancelDownload(std::string url);
+    Task<void> cancelDownloads(DownloadPriority priority);
 
     void clearCache();
     void clearMemoryCache();
 
+    // files under `CacheManager::cacheDir()`: downloads, interrupted downloads and pixels
+    struct DiskCacheUsage {
+        std::size_t files = 0;
+        std::uintmax_t bytes = 0;
+    };
+    static DiskCacheUsage diskCacheUsage();
+    // remove downloads and interrupted downloads untouched for `maxAge`, along with
+    // their decoded pixels, returns what was removed
+    static DiskCacheUsage collectGarbage(std::chrono::hours maxAge);
+
     std::string getTotalCacheSizeFormatString();
+    // hit/miss/eviction counters of the response cache by endpoint,
+    // also part of `diagnostics()->dump()`
+    std::map<std::string, CacheStats> cacheStats() const { return _cacheManager->snapshot(); }
+
+    // While offline (see `ConnectivityMonitor`) the client is cache-only:
+    // requests are answered from cache, even expired, or fail immediately.
+    // `listener` is called in the io thread when the client goes offline or back online.
+    Task<void> watchConnectivity(ConnectivityMonitor::Listener listener);
+
+    // Keeps the change feed of the backend open until the io context stops: a server-sent
+    // event stream of `/v2/client/event/changes` with
+    // - "event" events, data is an `EventEntity` created or changed
+    // - "deleted" events, data is `{"id": ...}`
+    // Reconnects with backoff and `Last-Event-ID`, while offline it waits for the network.
+    // A change is written into the cached event lists in place before `listener.change` is
+    // called, lists of the user it joins are dropped. `listener` is called in the io thread.
+    // API v1 has no change feed, it is `PushState::Unavailable` right away.
+    Task<void> watchChanges(ChangeListener listener);
+    // drop the current stream and connect again at once, e.g. for a new token
+    Task<void> reconnectChanges();
+    [[nodiscard]] PushState pushState() const { return _pushState; }
+
+    // open a connection to the API servers ahead of the first request, skipped while offline
+    Task<void> warmUpEvento();
+    Task<void> warmUpGithub();
+
+    // response body bytes on the wire vs. after content-decoding
+    TransferStats const& transferStats() const { return _httpsAccessManager->transferStats(); }
+    // per-endpoint latency histograms, also part of `diagnostics()->dump()`
+    NetworkMetrics const& metrics() const { return _metrics; }
 
     // access token
     // NOTE: `AUTOMATICALLY` added to request header if exists
@@ -133,14 +211,19 @@ private:
     // - success => return the `data` field from response json
     //            maybe json object or json array
     // - error => return error message
+    // - unchanged by `fingerprint` => return null, see `ResponseFingerprint`
     template<std::same_as<api::Evento> Api>
     Task<JsonResult> request(http::verb verb,
                              urls::url_view url,
                              std::initializer_list<urls::param> const& params = {},
-                             std::chrono::steady_clock::duration cacheTtl = 1min) {
+                             std::chrono::steady_clock::duration cacheTtl = 1min,
+                             ResponseFingerprint* fingerprint = nullptr) {
         spdlog::info("Requesting: {}", url.data());
 
         auto cacheKey = CacheManager::generateKey(verb, url, params);
+        auto metricsKey = metricsKeyOf(verb, url);
+        auto start = std::chrono::steady_clock::now();
+        RequestTiming timing;
 
         if (cacheTtl != 0s) {
             //Check cache
@@ -148,16 +231,64 @@ private:
 
             if (cacheEntry) {
                 spdlog::info("Cache hit: {}", cacheKey);
-                co_return Ok(cacheEntry->data);
+                timing.cache = RequestTiming::CacheState::Hit;
+                timing.total = std::chrono::duration_cast<RequestTiming::Duration>(
+                    std::chrono::steady_clock::now() - start);
+                recordTiming(metricsKey, timing);
+                co_return delivered(std::move(*cacheEntry), fingerprint);
             }
+            timing.cache = RequestTiming::CacheState::Miss;
         }
 
-        auto req = Api::makeRequest(verb, url, tokenBytes, params);
+        if (_connectivity->offline()) {
+            // cache-only mode, do not wait for a connection that cannot succeed
+            if (auto stale = _cacheManager->getStale(cacheKey)) {
+                spdlog::info("Offline, serving cache of {}", cacheKey);
+                timing.cache = RequestTiming::CacheState::Stale;
+                timing.total = std::chrono::duration_cast<RequestTiming::Duration>(
+                    std::chrono::steady_clock::now() - start);
+                recordTiming(metricsKey, timing);
+                co_return delivered(std::move(*stale), fingerprint);
+            }
+            co_return Err(Error(Error::Network, OFFLINE_REASON));
+        }
 
-        auto reply = co_await _httpsAccessManager->makeReply(url.host(), req);
+        auto req = Api::makeRequest(verb, url, tokenBytes, params);
 
-        if (reply.isErr())
+        auto reply = co_await _httpsAccessManager->makeReply(hostOf(url), req, &timing);
+        recordConnectivity(reply);
+
+        if (reply.isErr()) {
+            // better outdated data than an error while the backend is unreachable
+            auto kind = reply.unwrapErr().kind;
+            if (cacheTtl != 0s
+                && (kind == Error::Network || kind == Error::Timeout
+                    || kind == Error::Unavailable)) {
+                if (auto stale = _cacheManager->getStale(cacheKey)) {
+                    spdlog::warn("Serving stale cache of {}: {}",
+                                 cacheKey,
+                                 reply.unwrapErr().what());
+                    timing.cache = RequestTiming::CacheState::Stale;
+                    recordTiming(metricsKey, timing);
+                    co_return delivered(std::move(*stale), fingerprint);
+                }
+            }
+            recordTiming(metricsKey, timing);
             co_return reply.unwrapErr();
+        }
+        recordTiming(metricsKey, timing);
+
+        auto bodyFingerprint = fingerprintBody(reply.unwrap().body());
+        if (fingerprint && reply.unwrap().result() == http::status::ok) {
+            fingerprint->delivered = bodyFingerprint;
+            if (fingerprint->unchanged()) {
+                // the caller has it, so has the cache unless it was evicted meanwhile
+                if (cacheTtl != 0s) {
+                    _cacheManager->renew(cacheKey, bodyFingerprint, cacheTtl);
+                }
+                co_return Ok(nlohmann::basic_json<>());
+            }
+        }
 
         auto result = handleEventoResponse(reply.unwrap());
 
@@ -169,7 +300,8 @@ private:
                                   {.data = std::move(result.unwrap()),
                                    .insertTime = std::chrono::steady_clock::now(),
                                    .ttl = cacheTtl,
-                                   .size = entrySize});
+                                   .size = entrySize,
+                                   .fingerprint = bodyFingerprint});
         }
 
         co_return result;
@@ -181,8 +313,15 @@ private:
                              std::initializer_list<urls::param> const& params = {}) {
         spdlog::info("Requesting: {}", url.data());
 
+        if (_connectivity->offline()) {
+            co_return Err(Error(Error::Network, OFFLINE_REASON));
+        }
+
         auto req = Api::makeRequest(verb, url, std::nullopt, params);
-        auto reply = co_await _httpsAccessManager->makeReply(url.host(), req);
+        RequestTiming timing;
+        auto reply = co_await _httpsAccessManager->makeReply(hostOf(url), req, &timing);
+        recordConnectivity(reply);
+        recordTiming(metricsKeyOf(verb, url), timing);
         if (reply.isErr())
             co_return reply.unwrapErr();
 
@@ -203,11 +342,57 @@ private:
     static JsonResult handleEventoResponse(http::response<http::dynamic_body> response);
     Task<JsonResult> handleGithubResponse(http::response<http::dynamic_body> response);
 
-    static Task<bool> saveToDisk(std::string const& data, std::filesystem::path const& path);
+    // the data of a cache entry, or null if `fingerprint` has seen it
+    static JsonResult delivered(CacheEntry entry, ResponseFingerprint* fingerprint);
+    static Fingerprint fingerprintBody(http::dynamic_body::value_type const& body);
+
+    // connection failures feed the offline inference, anything else proves we are online,
+    // a host failing fast (`Error::Unavailable`) tells nothing about the network
+    template<typename T>
+    void recordConnectivity(Result<T> const& reply) {
+        if (reply.isOk()) {
+            _connectivity->recordSuccess();
+        } else if (auto kind = reply.unwrapErr().kind;
+                   kind == Error::Network || kind == Error::Timeout) {
+            _connectivity->recordFailure();
+        }
+    }
+
+    static constexpr const char OFFLINE_REASON[] = "Network unavailable";
+
+    // "host" or "host:port", what `HttpsAccessManager` connects to
+    static std::string hostOf(urls::url_view url);
+    static std::string metricsKeyOf(http::verb verb, urls::url_view url);
+    void recordTiming(std::string const& metricsKey, RequestTiming const& timing);
+
+    // one connection of the change feed, `Ok` with the status once it ended
+    Task<Result<http::status>> streamChanges(ChangeListener const& listener);
+    void onChangeEvent(ServerSentEvent const& event, ChangeListener const& listener);
+    // returns the number of cache entries patched
+    std::size_t applyChange(EventChange const& change);
+    void setPushState(PushState state, ChangeListener const& listener);
+
+    static constexpr std::chrono::seconds CHANGES_RETRY_MIN{1};
+    static constexpr std::chrono::seconds CHANGES_RETRY_MAX{60};
+    // a stream open this long resets the backoff
+    static constexpr std::chrono::seconds CHANGES_STABLE{30};
+    static constexpr std::chrono::minutes CHANGES_UNAVAILABLE_RETRY{30};
+
+    // download `url` into `dir` without looking at the disk cache
+    Task<Result<std::filesystem::path>> fetchFile(std::string url,
+                                                  std::filesystem::path dir,
+                                                  DownloadProgress progress);
 
 private:
     std::unique_ptr<HttpsAccessManager> _httpsAccessManager;
     std::unique_ptr<CacheManager> _cacheManager;
+    std::unique_ptr<DownloadManager> _downloadManager;
+    std::unique_ptr<ConnectivityMonitor> _connectivity;
+    NetworkMetrics _metrics;
+    // change feed, io thread only but `_pushState`
+    std::optional<net::steady_timer> _changesRestart; // cancelled by `reconnectChanges`
+    std::string _lastChangeId;
+    std::atomic<PushState> _pushState = PushState::Disconnected;
     friend NetworkClient* networkClient();
 
 #ifdef EVENTO_API_V1
@@ -0,0 +1,169 @@
+#include <Infrastructure/Network/NetworkMetrics.h>
+#include <algorithm>
+#include <cctype>
+#include <format>
+
+namespace evento {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+namespace {
+
+long long ms(microseconds duration) {
+    return duration_cast<milliseconds>(duration).count();
+}
+
+// mean of `sum` over `count` samples in milliseconds, 0 without samples
+long long averageMs(microseconds sum, std::uint64_t count) {
+    return count == 0 ? 0 : ms(sum / static_cast<long long>(count));
+}
+
+const char* cacheStateName(RequestTiming::CacheState state) {
+    switch (state) {
+    case RequestTiming::CacheState::Bypass:
+        return "bypass";
+    case RequestTiming::CacheState::Hit:
+        return "hit";
+    case RequestTiming::CacheState::Stale:
+        return "stale";
+    case RequestTiming::CacheState::Miss:
+        return "miss";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+std::string RequestTiming::summary() const {
+    if (cache == CacheState::Hit) {
+        return std::format("cache hit in {}us", total.count());
+    }
+    return std::format("total {}ms (dns {}ms, tcp {}ms, tls {}ms, ttfb {}ms, body {}ms), "
+                       "{} bytes, {}, {} attempt(s), cache {}{}",
+                       ms(total),
+                       ms(resolve),
+                       ms(connect),
+                       ms(handshake),
+                       ms(firstByte),
+                       ms(transfer),
+                       bodyBytes,
+                       reused ? "reused" : "new connection",
+                       attempts,
+                       cacheStateName(cache),
+                       failed ? ", failed" : "");
+}
+
+std::string NetworkMetrics::endpointOf(std::string_view method,
+                                       std::string_view host,
+                                       std::string_view path) {
+    std::string endpoint = std::format("{} {}", method, host);
+    if (auto query = path.find('?'); query != std::string_view::npos) {
+        path = path.substr(0, query);
+    }
+    // ids in the path would give every event its own endpoint
+    while (!path.empty()) {
+        auto begin = path.find_first_not_of('/');
+        if (begin == std::string_view::npos) {
+            break;
+        }
+        auto end = path.find('/', begin);
+        auto segment = path.substr(begin, end - begin);
+        bool numeric = std::all_of(segment.begin(), segment.end(), [](unsigned char c) {
+            return std::isdigit(c);
+        });
+        endpoint += '/';
+        endpoint += numeric ? "{id}" : segment;
+        path = end == std::string_view::npos ? std::string_view{} : path.substr(end);
+    }
+    return endpoint;
+}
+
+void NetworkMetrics::record(std::string const& endpoint, RequestTiming const& timing) {
+    std::lock_guard lock(_mutex);
+    auto& stats = _endpoints[endpoint];
+    if (timing.cache == RequestTiming::CacheState::Hit) {
+        ++stats.cacheHits;
+        return;
+    }
+    if (timing.cache == RequestTiming::CacheState::Stale) {
+        ++stats.staleHits;
+    }
+    if (timing.attempts == 0) {
+        // never reached the network, e.g. offline
+        return;
+    }
+
+    ++stats.requests;
+    stats.total.record(timing.total);
+    stats.firstByte.record(timing.firstByte);
+    stats.transfer += timing.transfer;
+    stats.bodyBytes += timing.bodyBytes;
+    stats.retries += timing.attempts - 1;
+    if (timing.failed) {
+        ++stats.failures;
+    }
+    if (timing.reused) {
+        ++stats.reused;
+    } else {
+        ++stats.newConnections;
+        stats.resolve += timing.resolve;
+        stats.connect += timing.connect;
+        stats.handshake += timing.handshake;
+    }
+}
+
+std::uint64_t NetworkMetrics::totalBodyBytes() const {
+    std::lock_guard lock(_mutex);
+    std::uint64_t total = 0;
+    for (auto const& [endpoint, stats] : _endpoints) {
+        total += stats.bodyBytes;
+    }
+    return total;
+}
+
+std::string NetworkMetrics::dump() const {
+    std::lock_guard lock(_mutex);
+    std::string result;
+    for (auto const& [endpoint, stats] : _endpoints) {
+        result += std::format("{}\n"
+                              "  {} requests, {} failed, {} retries, {} cache hits, {} stale\n",
+                              endpoint,
+                              stats.requests,
+                              stats.failures,
+                              stats.retries,
+                              stats.cacheHits,
+                              stats.staleHits);
+        if (stats.requests == 0) {
+            continue;
+        }
+        result += std::format(
+            "  total p50 {}ms p95 {}ms p99 {}ms max {}ms\n"
+            "  ttfb  p50 {}ms p95 {}ms, body avg {}ms, {:.1f}KiB\n"
+            "  {} new connections (dns {}ms, tcp {}ms, tls {}ms avg), {} reused\n"
+            "  buckets {}\n",
+            stats.total.percentile(0.5).count(),
+            stats.total.percentile(0.95).count(),
+            stats.total.percentile(0.99).count(),
+            stats.total.max().count(),
+            stats.firstByte.percentile(0.5).count(),
+            stats.firstByte.percentile(0.95).count(),
+            averageMs(stats.transfer, stats.requests),
+            static_cast<double>(stats.bodyBytes) / 1024,
+            stats.newConnections,
+            averageMs(stats.resolve, stats.newConnections),
+            averageMs(stats.connect, stats.newConnections),
+            averageMs(stats.handshake, stats.newConnections),
+            stats.reused,
+            stats.total.buckets());
+    }
+    return result.empty() ? "no requests yet\n" : result;
+}
+
+void NetworkMetrics::reset() {
+    std::lock_guard lock(_mutex);
+    _endpoints.clear();
+}
+
+} // namespace evento
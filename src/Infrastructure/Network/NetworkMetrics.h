@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Infrastructure/Utils/LatencyHistogram.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace evento {
+
+// where the time of one request went, filled by `HttpsAccessManager` and `NetworkClient`
+struct RequestTiming {
+    using Duration = std::chrono::microseconds;
+
+    enum class CacheState {
+        Bypass, // not cacheable
+        Hit,    // answered from cache, no network involved
+        Stale,  // answered from expired cache because the network failed
+        Miss,   // fetched and cached
+    };
+
+    // connection setup, zero if a pooled connection was reused
+    Duration resolve{};
+    Duration connect{};
+    Duration handshake{};
+    // from writing the request until the response header is read
+    Duration firstByte{};
+    // reading the response body
+    Duration transfer{};
+    // the whole request as seen by the caller, including retries and backoff
+    Duration total{};
+
+    std::size_t bodyBytes = 0; // on the wire, before content-decoding
+    bool reused = false;
+    int attempts = 0;
+    bool failed = false;
+    CacheState cache = CacheState::Bypass;
+    // groups the phase spans of the request in the trace, 0 while tracing is off
+    std::uint64_t traceId = 0;
+
+    [[nodiscard]] std::string summary() const;
+};
+
+// Aggregates `RequestTiming`s per endpoint, safe to use from any thread.
+class NetworkMetrics {
+public:
+    // "GET host/path" with numeric path segments folded into "{id}", queries dropped
+    static std::string endpointOf(std::string_view method,
+                                  std::string_view host,
+                                  std::string_view path);
+
+    void record(std::string const& endpoint, RequestTiming const& timing);
+    // response bodies received over all endpoints, on the wire
+    [[nodiscard]] std::uint64_t totalBodyBytes() const;
+    // human readable table of every endpoint, for the diagnostics dump
+    [[nodiscard]] std::string dump() const;
+    void reset();
+
+private:
+    struct EndpointStats {
+        LatencyHistogram total;     // requests that hit the network
+        LatencyHistogram firstByte; // same
+        // summed over `newConnections` and network requests, averaged when dumped
+        RequestTiming::Duration resolve{};
+        RequestTiming::Duration connect{};
+        RequestTiming::Duration handshake{};
+        RequestTiming::Duration transfer{};
+        std::uint64_t requests = 0;
+        std::uint64_t newConnections = 0;
+        std::uint64_t reused = 0;
+        std::uint64_t retries = 0;
+        std::uint64_t failures = 0;
+        std::uint64_t cacheHits = 0;
+        std::uint64_t staleHits = 0;
+        std::uint64_t bodyBytes = 0;
+    };
+
+    mutable std::mutex _mutex;
+    std::map<std::string, EndpointStats> _endpoints; // sorted for a stable dump
+};
+
+} // namespace evento
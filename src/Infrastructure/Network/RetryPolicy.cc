@@ -0,0 +1,77 @@
+#include <Infrastructure/Network/RetryPolicy.h>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace evento {
+
+std::chrono::milliseconds RetryPolicy::delay(int retry, std::mt19937& random) const {
+    auto ceiling = baseDelay.count() << std::clamp(retry, 0, 16);
+    ceiling = std::min<std::chrono::milliseconds::rep>(ceiling, maxDelay.count());
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution(0, ceiling);
+    return std::chrono::milliseconds(distribution(random));
+}
+
+bool CircuitBreaker::allow(std::string const& host) {
+    auto it = _hosts.find(host);
+    if (it == _hosts.end()) {
+        return true;
+    }
+    auto& entry = it->second;
+    switch (entry.state) {
+    case State::Closed:
+        return true;
+    case State::Open:
+        if (std::chrono::steady_clock::now() - entry.openedAt < _openDuration) {
+            return false;
+        }
+        spdlog::info("Circuit of {} is half-open, sending a trial request", host);
+        entry.state = State::HalfOpen;
+        entry.trialInFlight = true;
+        return true;
+    case State::HalfOpen:
+        // only one trial at a time
+        if (entry.trialInFlight) {
+            return false;
+        }
+        entry.trialInFlight = true;
+        return true;
+    }
+    return true;
+}
+
+void CircuitBreaker::recordSuccess(std::string const& host) {
+    auto it = _hosts.find(host);
+    if (it == _hosts.end()) {
+        return;
+    }
+    if (it->second.state != State::Closed) {
+        spdlog::info("Circuit of {} is closed", host);
+    }
+    _hosts.erase(it);
+}
+
+void CircuitBreaker::recordFailure(std::string const& host) {
+    auto& entry = _hosts[host];
+    entry.trialInFlight = false;
+    ++entry.failures;
+    if (entry.state == State::HalfOpen || entry.failures >= _failureThreshold) {
+        if (entry.state != State::Open) {
+            spdlog::warn("Circuit of {} is open after {} failures", host, entry.failures);
+        }
+        entry.state = State::Open;
+        entry.openedAt = std::chrono::steady_clock::now();
+    }
+}
+
+void CircuitBreaker::recordAbandoned(std::string const& host) {
+    if (auto it = _hosts.find(host); it != _hosts.end()) {
+        it->second.trialInFlight = false;
+    }
+}
+
+CircuitBreaker::State CircuitBreaker::state(std::string const& host) const {
+    auto it = _hosts.find(host);
+    return it == _hosts.end() ? State::Closed : it->second.state;
+}
+
+} // namespace evento
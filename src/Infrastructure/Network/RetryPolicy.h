@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace evento {
+
+// Capped exponential backoff with full jitter:
+// the n-th retry waits a uniformly random time in [0, min(maxDelay, baseDelay * 2^n)].
+struct RetryPolicy {
+    int maxAttempts = 3; // including the first one
+    std::chrono::milliseconds baseDelay{200};
+    std::chrono::milliseconds maxDelay{2000};
+
+    std::chrono::milliseconds delay(int retry, std::mt19937& random) const;
+};
+
+// Per-host circuit breaker.
+// After `failureThreshold` consecutive failures the circuit of a host opens and requests
+// to it fail fast for `openDuration`. Then a single trial request is let through
+// (half-open): success closes the circuit again, failure re-opens it.
+class CircuitBreaker {
+public:
+    enum class State {
+        Closed,
+        Open,
+        HalfOpen,
+    };
+
+    CircuitBreaker(int failureThreshold = 5,
+                   std::chrono::steady_clock::duration openDuration = std::chrono::seconds(30))
+        : _failureThreshold(failureThreshold)
+        , _openDuration(openDuration) {}
+
+    // whether a request to `host` may be sent now
+    bool allow(std::string const& host);
+    void recordSuccess(std::string const& host);
+    void recordFailure(std::string const& host);
+    // a request let through ended with neither, e.g. it was cancelled,
+    // frees the half-open trial for the next request
+    void recordAbandoned(std::string const& host);
+
+    State state(std::string const& host) const;
+
+private:
+    struct HostState {
+        State state = State::Closed;
+        int failures = 0;
+        std::chrono::steady_clock::time_point openedAt;
+        bool trialInFlight = false;
+    };
+
+    int _failureThreshold;
+    std::chrono::steady_clock::duration _openDuration;
+    std::unordered_map<std::string, HostState> _hosts;
+};
+
+} // namespace evento
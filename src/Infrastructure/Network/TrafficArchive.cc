@@ -0,0 +1,247 @@
+#include <Infrastructure/Network/TrafficArchive.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <format>
+#include <spdlog/spdlog.h>
+
+namespace evento {
+
+namespace fs = std::filesystem;
+
+// The archive is "EVTA", the version, then one record per response, all integers
+// little-endian, strings as a u32 length and the bytes:
+//     u64 elapsed microseconds, string key, u32 status,
+//     u32 field count, (string name, string value) per field, string body
+
+namespace {
+
+void writeInt(std::ofstream& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+void writeString(std::ofstream& out, std::string_view value) {
+    writeInt(out, value.size(), 4);
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// reads what `writeInt` and `writeString` wrote, `false` at the end or on truncation
+bool readInt(std::ifstream& in, std::uint64_t& value, int bytes) {
+    value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        auto c = in.get();
+        if (c == std::ifstream::traits_type::eof()) {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(c)) << (8 * i);
+    }
+    return true;
+}
+
+bool readString(std::ifstream& in, std::string& value) {
+    std::uint64_t size = 0;
+    if (!readInt(in, size, 4)) {
+        return false;
+    }
+    value.resize(size);
+    in.read(value.data(), static_cast<std::streamsize>(size));
+    return in.gcount() == static_cast<std::streamsize>(size);
+}
+
+// "2024-05-13", with the time that may follow it, e.g. "T00:00:00.000Z" or "T00%3A00%3A00Z",
+// the size of it at `pos` or 0 if there is none
+std::size_t dateAt(std::string_view text, std::size_t pos) {
+    constexpr std::string_view PATTERN = "0000-00-00";
+    if (text.size() - pos < PATTERN.size()) {
+        return 0;
+    }
+    for (std::size_t i = 0; i < PATTERN.size(); ++i) {
+        auto c = text[pos + i];
+        if (PATTERN[i] == '-' ? c != '-' : (c < '0' || c > '9')) {
+            return 0;
+        }
+    }
+    auto end = pos + PATTERN.size();
+    while (end < text.size()) {
+        auto rest = text.substr(end);
+        if (rest.starts_with("%3A") || rest.starts_with("%3a")) {
+            end += 3;
+        } else if (std::string_view("0123456789:.TZ").find(rest[0]) != std::string_view::npos) {
+            ++end;
+        } else {
+            break;
+        }
+    }
+    return end - pos;
+}
+
+void appendWithoutDates(std::string& key, std::string_view text) {
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        if (auto size = dateAt(text, pos)) {
+            key += "<date>";
+            pos += size;
+        } else {
+            key += text[pos++];
+        }
+    }
+}
+
+bool readEntry(std::ifstream& in, std::string& key, TrafficArchive::Entry& entry) {
+    std::uint64_t elapsed = 0;
+    std::uint64_t status = 0;
+    std::uint64_t fieldCount = 0;
+    if (!readInt(in, elapsed, 8) || !readString(in, key) || !readInt(in, status, 4)
+        || !readInt(in, fieldCount, 4)) {
+        return false;
+    }
+    entry.elapsed = std::chrono::microseconds(elapsed);
+    entry.status = static_cast<unsigned>(status);
+    entry.fields.resize(fieldCount);
+    for (auto& [name, value] : entry.fields) {
+        if (!readString(in, name) || !readString(in, value)) {
+            return false;
+        }
+    }
+    return readString(in, entry.body);
+}
+
+} // namespace
+
+std::unique_ptr<TrafficArchive> TrafficArchive::fromEnvironment() {
+#if defined(EVENTO_DEBUG) || defined(EVENTO_GATEWAY_OVERRIDE)
+    if (auto path = std::getenv("EVENTO_TRAFFIC_REPLAY"); path && *path) {
+        double speed = 1;
+        if (auto value = std::getenv("EVENTO_TRAFFIC_SPEED"); value && *value) {
+            std::string_view text = value;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), speed);
+            if (ec != std::errc{} || end != text.data() + text.size() || speed < 0) {
+                spdlog::warn("Ignoring invalid EVENTO_TRAFFIC_SPEED: {}", text);
+                speed = 1;
+            }
+        }
+        return replay(path, speed);
+    }
+    if (auto path = std::getenv("EVENTO_TRAFFIC_RECORD"); path && *path) {
+        return record(path);
+    }
+#endif
+    return nullptr;
+}
+
+std::unique_ptr<TrafficArchive> TrafficArchive::record(fs::path const& path) {
+    std::unique_ptr<TrafficArchive> archive(new TrafficArchive(Mode::Record));
+    archive->_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!archive->_out.is_open()) {
+        spdlog::error("Cannot write traffic archive {}", path.string());
+        return nullptr;
+    }
+    archive->_out.write(MAGIC, 4);
+    writeInt(archive->_out, VERSION, 4);
+    archive->_out.flush();
+    spdlog::info("Recording network traffic to {}", path.string());
+    return archive;
+}
+
+std::unique_ptr<TrafficArchive> TrafficArchive::replay(fs::path const& path, double speed) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        spdlog::error("Cannot read traffic archive {}", path.string());
+        return nullptr;
+    }
+    char magic[4]{};
+    std::uint64_t version = 0;
+    in.read(magic, 4);
+    if (std::string_view(magic, 4) != std::string_view(MAGIC, 4) || !readInt(in, version, 4)
+        || version != VERSION) {
+        spdlog::error("{} is not a traffic archive of version {}", path.string(), VERSION);
+        return nullptr;
+    }
+
+    std::unique_ptr<TrafficArchive> archive(new TrafficArchive(Mode::Replay));
+    archive->_speed = speed;
+    std::string key;
+    Entry entry;
+    while (in.peek() != std::ifstream::traits_type::eof()) {
+        if (!readEntry(in, key, entry)) {
+            // the recording app was killed mid-write, keep what is complete
+            spdlog::warn("Traffic archive {} is truncated", path.string());
+            break;
+        }
+        archive->_entries[key].first.push_back(std::move(entry));
+        ++archive->_size;
+        entry = {};
+    }
+    spdlog::info("Replaying {} responses from {} at speed {}",
+                 archive->_size,
+                 path.string(),
+                 speed);
+    return archive;
+}
+
+std::string TrafficArchive::keyOf(std::string_view host,
+                                  http::request<http::string_body> const& req) {
+    auto key = std::format("{} {}", std::string(http::to_string(req.method())), host);
+    appendWithoutDates(key, std::string_view(req.target().data(), req.target().size()));
+    if (!req.body().empty()) {
+        key += '\n';
+        appendWithoutDates(key, req.body());
+    }
+    return key;
+}
+
+void TrafficArchive::add(std::string const& key,
+                         std::chrono::steady_clock::duration elapsed,
+                         http::response_header<> const& header,
+                         std::string body) {
+    writeInt(_out,
+             std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+             8);
+    writeString(_out, key);
+    writeInt(_out, header.result_int(), 4);
+    writeInt(_out, std::distance(header.begin(), header.end()), 4);
+    for (auto const& field : header) {
+        auto name = field.name_string();
+        auto value = field.value();
+        writeString(_out, std::string_view(name.data(), name.size()));
+        writeString(_out, std::string_view(value.data(), value.size()));
+    }
+    writeString(_out, body);
+    // every record is complete on disk, whenever the app exits
+    _out.flush();
+    ++_size;
+}
+
+std::optional<TrafficArchive::Entry> TrafficArchive::next(std::string const& key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return std::nullopt;
+    }
+    auto& [entries, served] = it->second;
+    auto index = std::min(served, entries.size() - 1);
+    ++served;
+    return entries[index];
+}
+
+http::response_header<> TrafficArchive::headerOf(Entry const& entry) {
+    http::response_header<> header;
+    header.version(11);
+    header.result(entry.status);
+    for (auto const& [name, value] : entry.fields) {
+        header.insert(name, value);
+    }
+    return header;
+}
+
+std::chrono::steady_clock::duration TrafficArchive::delayOf(Entry const& entry) const {
+    if (_speed == 0) {
+        return {};
+    }
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::micro>(static_cast<double>(entry.elapsed.count())
+                                                  / _speed));
+}
+
+} // namespace evento
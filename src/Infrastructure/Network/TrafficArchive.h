@@ -0,0 +1,94 @@
+#pragma once
+
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace evento {
+
+namespace beast = boost::beast; // from <boost/beast.hpp>
+namespace http = beast::http;   // from <boost/beast/http.hpp>
+
+// Responses captured by `HttpsAccessManager` with the time they took, to be served again
+// without network, e.g. for reproducible performance runs on real payloads:
+// - record: every response received is appended to the archive, as decoded by the client
+// - replay: requests are answered from the archive after the recorded time, scaled by `speed`,
+//   nothing is sent. Responses to the same request come back in the order they were recorded,
+//   the last one is repeated once they run out, unknown requests fail with `Error::Data`.
+//
+// Requests are matched by method, host, target and body, not by headers. Dates in the target
+// and body are left out, requests for "this week" of a capture are matched in any later week.
+// The archive holds the response headers and bodies as they are, tokens and personal data
+// included.
+//
+// Set up from the environment, see `fromEnvironment()`.
+// All members must be called in the io thread.
+class TrafficArchive {
+public:
+    enum class Mode {
+        Record,
+        Replay,
+    };
+
+    struct Entry {
+        std::chrono::microseconds elapsed;
+        unsigned status = 200;
+        std::vector<std::pair<std::string, std::string>> fields;
+        std::string body;
+    };
+
+    // `EVENTO_TRAFFIC_RECORD=<path>` or `EVENTO_TRAFFIC_REPLAY=<path>`, the replay speed is
+    // `EVENTO_TRAFFIC_SPEED`, 1 by default, e.g. 2 for half the recorded time, 0 for no delay.
+    // `nullptr` if neither is set or the archive cannot be opened. Debug and bench builds
+    // only, like the gateway overrides, a recording holds the tokens of the user.
+    static std::unique_ptr<TrafficArchive> fromEnvironment();
+    // truncates `path`, `nullptr` if it cannot be written
+    static std::unique_ptr<TrafficArchive> record(std::filesystem::path const& path);
+    // `nullptr` if `path` cannot be read or is not an archive
+    static std::unique_ptr<TrafficArchive> replay(std::filesystem::path const& path,
+                                                  double speed = 1);
+
+    [[nodiscard]] Mode mode() const { return _mode; }
+    [[nodiscard]] std::size_t size() const { return _size; }
+
+    // the request with dates, also URL encoded ones, replaced by `<date>`
+    static std::string keyOf(std::string_view host, http::request<http::string_body> const& req);
+
+    // record mode only
+    void add(std::string const& key,
+             std::chrono::steady_clock::duration elapsed,
+             http::response_header<> const& header,
+             std::string body);
+    // replay mode only, the next response to `key`
+    std::optional<Entry> next(std::string const& key);
+    static http::response_header<> headerOf(Entry const& entry);
+    // how long to take for `entry` at the replay speed
+    [[nodiscard]] std::chrono::steady_clock::duration delayOf(Entry const& entry) const;
+
+    static constexpr char MAGIC[] = "EVTA";
+    // 2 leaves dates out of the keys
+    static constexpr std::uint32_t VERSION = 2;
+
+private:
+    explicit TrafficArchive(Mode mode)
+        : _mode(mode) {}
+
+    Mode _mode;
+    std::size_t _size = 0;
+    double _speed = 1;
+    std::ofstream _out;
+    // key -> responses in recorded order, and how many of them were served
+    std::unordered_map<std::string, std::pair<std::vector<Entry>, std::size_t>> _entries;
+};
+
+} // namespace evento
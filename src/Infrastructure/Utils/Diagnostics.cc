@@ -0,0 +1,37 @@
+#include <Infrastructure/Utils/Diagnostics.h>
+#include <algorithm>
+
+namespace evento {
+
+void Diagnostics::add(std::string name, Section render) {
+    std::lock_guard lock(_mutex);
+    auto it = std::find_if(_sections.begin(), _sections.end(), [&name](auto const& section) {
+        return section.first == name;
+    });
+    if (it != _sections.end()) {
+        it->second = std::move(render);
+        return;
+    }
+    _sections.emplace_back(std::move(name), std::move(render));
+}
+
+void Diagnostics::remove(std::string const& name) {
+    std::lock_guard lock(_mutex);
+    std::erase_if(_sections, [&name](auto const& section) { return section.first == name; });
+}
+
+std::string Diagnostics::dump() const {
+    std::lock_guard lock(_mutex);
+    std::string result;
+    for (auto const& [name, render] : _sections) {
+        result += "[" + name + "]\n" + render();
+    }
+    return result;
+}
+
+Diagnostics* diagnostics() {
+    static Diagnostics s_instance;
+    return &s_instance;
+}
+
+} // namespace evento
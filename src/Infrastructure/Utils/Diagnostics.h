@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace evento {
+
+// Registry of runtime state worth looking at while debugging, e.g. network latency.
+// Each section renders itself on demand, `dump()` is triggered by SIGUSR1 on POSIX.
+class Diagnostics {
+public:
+    using Section = std::function<std::string()>;
+
+    // `render` may be called from any thread
+    void add(std::string name, Section render);
+    void remove(std::string const& name);
+    [[nodiscard]] std::string dump() const;
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<std::pair<std::string, Section>> _sections; // in registration order
+};
+
+Diagnostics* diagnostics();
+
+} // namespace evento
@@ -15,6 +15,8 @@ public:
         Data,
         Unknown,
         Timeout,
+        Cancelled,
+        Unavailable, // a host failing fast for a while, not a problem of the network
     } kind;
 
     Error(Kind kind, std::string_view reason)
@@ -41,12 +43,14 @@ public:
 private:
     std::string _reason;
 
-    inline static std::string _reasonMap[Timeout + 1] = {"SSL error!",
-                                                         "Network error!",
-                                                         "Json Deserialization error!",
-                                                         "Data error",
-                                                         "Unknown Error",
-                                                         "Timeout error!"};
+    inline static std::string _reasonMap[Unavailable + 1] = {"SSL error!",
+                                                             "Network error!",
+                                                             "Json Deserialization error!",
+                                                             "Data error",
+                                                             "Unknown Error",
+                                                             "Timeout error!",
+                                                             "Cancelled",
+                                                             "Service unavailable"};
 
     inline static std::unordered_map<unsigned, std::string> _httpStatusCodeMap = {
         {400u, "400 Bad Request"},
@@ -0,0 +1,71 @@
+#include <Infrastructure/Utils/Fingerprint.h>
+
+#ifdef EVENTO_HAS_XXHASH
+#include <xxhash.h>
+#endif
+
+namespace evento {
+
+namespace {
+
+Fingerprint nonZero(std::uint64_t hash) {
+    return hash == 0 ? 1 : hash;
+}
+
+} // namespace
+
+#ifdef EVENTO_HAS_XXHASH
+
+struct Fingerprinter::State {
+    State()
+        : xxh3(XXH3_createState()) {
+        XXH3_64bits_reset(xxh3);
+    }
+    ~State() { XXH3_freeState(xxh3); }
+
+    XXH3_state_t* xxh3;
+};
+
+void Fingerprinter::update(std::string_view bytes) {
+    XXH3_64bits_update(_state->xxh3, bytes.data(), bytes.size());
+}
+
+Fingerprint Fingerprinter::digest() const {
+    return nonZero(XXH3_64bits_digest(_state->xxh3));
+}
+
+Fingerprint fingerprintOf(std::string_view bytes) {
+    return nonZero(XXH3_64bits(bytes.data(), bytes.size()));
+}
+
+#else
+
+struct Fingerprinter::State {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+};
+
+void Fingerprinter::update(std::string_view bytes) {
+    for (auto byte : bytes) {
+        _state->hash ^= static_cast<unsigned char>(byte);
+        _state->hash *= 0x100000001b3ull;
+    }
+}
+
+Fingerprint Fingerprinter::digest() const {
+    return nonZero(_state->hash);
+}
+
+Fingerprint fingerprintOf(std::string_view bytes) {
+    Fingerprinter fingerprinter;
+    fingerprinter.update(bytes);
+    return fingerprinter.digest();
+}
+
+#endif
+
+Fingerprinter::Fingerprinter()
+    : _state(std::make_unique<State>()) {}
+
+Fingerprinter::~Fingerprinter() = default;
+
+} // namespace evento
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace evento {
+
+// Cheap identity of a response body, to tell an unchanged one without decoding it:
+// XXH3 when built with xxHash, 64-bit FNV-1a otherwise. Not collision resistant against
+// anyone trying, equal fingerprints are taken for equal bodies. Never 0, 0 stands for none.
+using Fingerprint = std::uint64_t;
+
+// fingerprint of bytes arriving in pieces, equal to `fingerprintOf` of them joined
+class Fingerprinter {
+public:
+    Fingerprinter();
+    ~Fingerprinter();
+    Fingerprinter(const Fingerprinter&) = delete;
+    Fingerprinter& operator=(const Fingerprinter&) = delete;
+
+    void update(std::string_view bytes);
+    [[nodiscard]] Fingerprint digest() const;
+
+private:
+    struct State;
+    std::unique_ptr<State> _state;
+};
+
+Fingerprint fingerprintOf(std::string_view bytes);
+
+// For callers that skip what they have shown already, e.g. a view reloading on show:
+// the response is not decoded while its body matches `seen`, the result is empty then.
+struct ResponseFingerprint {
+    Fingerprint seen = 0;      // of the body delivered last, 0 for none
+    Fingerprint delivered = 0; // of the body of this response, 0 if unknown
+
+    [[nodiscard]] bool unchanged() const { return seen != 0 && seen == delivered; }
+};
+
+} // namespace evento
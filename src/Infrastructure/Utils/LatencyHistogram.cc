@@ -0,0 +1,58 @@
+#include <Infrastructure/Utils/LatencyHistogram.h>
+#include <algorithm>
+#include <format>
+
+namespace evento {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+void LatencyHistogram::record(microseconds sample) {
+    auto sampleMs = duration_cast<milliseconds>(sample).count();
+    auto it = std::find_if(BOUNDS.begin(), BOUNDS.end(), [sampleMs](std::uint32_t bound) {
+        return sampleMs <= bound;
+    });
+    ++_buckets[it - BOUNDS.begin()];
+    ++_count;
+    _sum += sample;
+    _max = std::max(_max, sample);
+}
+
+milliseconds LatencyHistogram::max() const {
+    return duration_cast<milliseconds>(_max);
+}
+
+milliseconds LatencyHistogram::mean() const {
+    return _count == 0 ? milliseconds{0}
+                       : duration_cast<milliseconds>(_sum / static_cast<long long>(_count));
+}
+
+milliseconds LatencyHistogram::percentile(double ratio) const {
+    if (_count == 0) {
+        return milliseconds{0};
+    }
+    auto rank = static_cast<std::uint64_t>(ratio * static_cast<double>(_count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BOUNDS.size(); ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(milliseconds{BOUNDS[i]}, max());
+        }
+    }
+    return max();
+}
+
+std::string LatencyHistogram::buckets() const {
+    std::string result;
+    for (std::size_t i = 0; i < _buckets.size(); ++i) {
+        if (!result.empty()) {
+            result += ' ';
+        }
+        result += i < BOUNDS.size() ? std::format("<={}:{}", BOUNDS[i], _buckets[i])
+                                    : std::format(">{}:{}", BOUNDS.back(), _buckets[i]);
+    }
+    return result;
+}
+
+} // namespace evento
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace evento {
+
+// latency samples in fixed log-scale buckets, cheap enough to keep many, not synchronized
+class LatencyHistogram {
+public:
+    // upper bounds in milliseconds, samples above the last one go to an overflow bucket
+    static constexpr std::array<std::uint32_t, 11> BOUNDS{
+        5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000};
+
+    void record(std::chrono::microseconds sample);
+
+    [[nodiscard]] std::uint64_t count() const { return _count; }
+    [[nodiscard]] std::chrono::milliseconds max() const;
+    [[nodiscard]] std::chrono::milliseconds mean() const;
+    // upper bound of the bucket holding the `ratio` quantile, `max()` for the overflow bucket
+    [[nodiscard]] std::chrono::milliseconds percentile(double ratio) const;
+    // bucket counts in one line, e.g. "<=5:0 <=10:3 ... >10000:0"
+    [[nodiscard]] std::string buckets() const;
+
+private:
+    std::array<std::uint64_t, BOUNDS.size() + 1> _buckets{};
+    std::uint64_t _count = 0;
+    std::chrono::microseconds _sum{};
+    std::chrono::microseconds _max{};
+};
+
+} // namespace evento
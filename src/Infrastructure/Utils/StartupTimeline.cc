@@ -0,0 +1,189 @@
+#include <Infrastructure/Utils/Diagnostics.h>
+#include <Infrastructure/Utils/StartupTimeline.h>
+#include <Infrastructure/Utils/Trace.h>
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#elif defined(PLATFORM_LINUX)
+#include <sstream>
+#include <unistd.h>
+#endif
+
+namespace evento {
+
+namespace {
+
+// how long the process ran before the timeline was created, zero where unknown
+std::chrono::microseconds sinceProcessStart() {
+#ifdef PLATFORM_WINDOWS
+    FILETIME creation, exit, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return {};
+    }
+    GetSystemTimePreciseAsFileTime(&now);
+    auto ticks = [](FILETIME time) {
+        return (static_cast<std::int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    // in units of 100ns
+    return std::chrono::microseconds(std::max<std::int64_t>(0, ticks(now) - ticks(creation)) / 10);
+#elif defined(PLATFORM_LINUX)
+    // both in the boot time clock, the start time in clock ticks, i.e. 10ms resolution
+    std::ifstream stat("/proc/self/stat");
+    std::ifstream uptime("/proc/uptime");
+    std::string line;
+    double uptimeSeconds = 0;
+    if (!std::getline(stat, line) || !(uptime >> uptimeSeconds)) {
+        return {};
+    }
+    // the command name may contain spaces, the fields after it are space separated,
+    // the start time is the 22nd field, i.e. the 20th after the name
+    auto end = line.rfind(')');
+    if (end == std::string::npos) {
+        return {};
+    }
+    std::istringstream fields(line.substr(end + 1));
+    std::string field;
+    for (int i = 0; i < 20 && fields >> field; ++i) {
+    }
+    auto ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (!fields || ticksPerSecond <= 0) {
+        return {};
+    }
+    auto startSeconds = std::strtod(field.c_str(), nullptr) / static_cast<double>(ticksPerSecond);
+    auto elapsed = std::max(0.0, uptimeSeconds - startSeconds);
+    return std::chrono::microseconds(static_cast<std::int64_t>(elapsed * 1e6));
+#else
+    return {};
+#endif
+}
+
+double toMs(std::chrono::microseconds value) {
+    return static_cast<double>(value.count()) / 1000;
+}
+
+} // namespace
+
+StartupTimeline::StartupTimeline()
+    : _origin(Clock::now() - sinceProcessStart())
+    , _last(_origin) {
+    // started before any span of the timeline, so that none begins before the trace does
+    (void) tracer();
+    if (auto path = std::getenv("EVENTO_STARTUP_REPORT"); path && *path) {
+        _reportPath = path;
+    }
+    diagnostics()->add("startup", [this] { return dump(); });
+}
+
+void StartupTimeline::mark(std::string_view phase) {
+    auto now = Clock::now();
+    Clock::time_point start;
+    {
+        std::lock_guard lock(_mutex);
+        if (std::any_of(_phases.begin(), _phases.end(), [phase](auto const& entry) {
+                return entry.name == phase;
+            })) {
+            return;
+        }
+        start = _last;
+        _last = now;
+        _phases.push_back(
+            {.name = std::string(phase),
+             .at = std::chrono::duration_cast<std::chrono::microseconds>(now - _origin),
+             .duration = std::chrono::duration_cast<std::chrono::microseconds>(now - start)});
+    }
+    // the first phase runs before `main`, i.e. before the trace started
+    if (start != _origin) {
+        tracer()->complete("startup", phase, start);
+    }
+    if (complete()) {
+        finish();
+    }
+}
+
+bool StartupTimeline::completeLocked() const {
+    auto marked = [this](std::string_view phase) {
+        return std::any_of(_phases.begin(), _phases.end(), [phase](auto const& entry) {
+            return entry.name == phase;
+        });
+    };
+    return marked(FIRST_FRAME) && marked(FIRST_DATA);
+}
+
+bool StartupTimeline::complete() const {
+    std::lock_guard lock(_mutex);
+    return completeLocked();
+}
+
+void StartupTimeline::onComplete(std::function<void()> handler) {
+    std::lock_guard lock(_mutex);
+    _onComplete = std::move(handler);
+}
+
+void StartupTimeline::finish() {
+    std::function<void()> handler;
+    {
+        std::lock_guard lock(_mutex);
+        if (_finished) {
+            return;
+        }
+        _finished = true;
+        handler = _onComplete;
+    }
+    spdlog::info("Startup complete:\n{}", dump());
+    if (!reporting()) {
+        return;
+    }
+    std::ofstream out(_reportPath, std::ios::trunc);
+    out << json();
+    if (!out) {
+        spdlog::error("Cannot write startup report {}", _reportPath.string());
+    }
+    out.close();
+    if (handler) {
+        handler();
+    }
+}
+
+std::vector<StartupTimeline::Phase> StartupTimeline::phases() const {
+    std::lock_guard lock(_mutex);
+    return _phases;
+}
+
+std::string StartupTimeline::dump() const {
+    std::string result;
+    for (auto const& phase : phases()) {
+        result += std::format("{:<22} +{:>8.1f}ms  @{:>8.1f}ms\n",
+                              phase.name,
+                              toMs(phase.duration),
+                              toMs(phase.at));
+    }
+    return result;
+}
+
+std::string StartupTimeline::json() const {
+    std::string result = R"({"phases":[)";
+    bool first = true;
+    // phase names are literals of the app, no escaping needed
+    for (auto const& phase : phases()) {
+        result += std::format(R"({}{{"name":"{}","atMs":{:.3f},"durationMs":{:.3f}}})",
+                              first ? "" : ",",
+                              phase.name,
+                              toMs(phase.at),
+                              toMs(phase.duration));
+        first = false;
+    }
+    result += "]}\n";
+    return result;
+}
+
+StartupTimeline* startupTimeline() {
+    static StartupTimeline s_instance;
+    return &s_instance;
+}
+
+} // namespace evento
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace evento {
+
+// Timestamps of the startup phases, from process start to the first frame and the first
+// events shown. Each `mark()` ends a phase that began with the previous one, the time before
+// `main` is measured from the OS process start time where available (Linux, Windows).
+//
+// The phases go to the "startup" diagnostics section, the log and, as spans, the trace.
+// With `EVENTO_STARTUP_REPORT=<path>` they are also written as JSON once startup is complete,
+// then the completion handler runs, which quits the app: see `bench/startup.py`.
+class StartupTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase {
+        std::string name;
+        std::chrono::microseconds at;       // since process start
+        std::chrono::microseconds duration; // since the previous phase
+    };
+
+    // phases that complete startup, marked in any order
+    static constexpr std::string_view FIRST_FRAME = "first frame";
+    static constexpr std::string_view FIRST_DATA = "first data";
+
+    StartupTimeline(const StartupTimeline&) = delete;
+    StartupTimeline& operator=(const StartupTimeline&) = delete;
+
+    // end of `phase`, repeated marks of the same phase are ignored, thread-safe
+    void mark(std::string_view phase);
+    [[nodiscard]] bool complete() const;
+    [[nodiscard]] bool reporting() const { return !_reportPath.empty(); }
+    // called once, from the thread marking the last phase, if a report was requested
+    void onComplete(std::function<void()> handler);
+
+    [[nodiscard]] std::vector<Phase> phases() const;
+    // one line per phase: name, duration and time since process start
+    [[nodiscard]] std::string dump() const;
+    // {"phases":[{"name":..,"atMs":..,"durationMs":..},..]}
+    [[nodiscard]] std::string json() const;
+
+private:
+    StartupTimeline();
+
+    bool completeLocked() const;
+    void finish();
+
+    Clock::time_point _origin; // process start
+    Clock::time_point _last;
+    std::filesystem::path _reportPath;
+    std::function<void()> _onComplete;
+    mutable std::mutex _mutex;
+    std::vector<Phase> _phases;
+    bool _finished = false;
+
+    friend StartupTimeline* startupTimeline();
+};
+
+StartupTimeline* startupTimeline();
+
+} // namespace evento
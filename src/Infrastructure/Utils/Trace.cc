@@ -0,0 +1,199 @@
+#include <Infrastructure/Utils/Trace.h>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+namespace evento {
+
+namespace {
+
+void appendEscaped(std::string& out, std::string_view text) {
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += std::format("\\u{:04x}", static_cast<int>(c));
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+} // namespace
+
+Tracer::Tracer()
+    : _start(Clock::now()) {
+    auto path = std::getenv("EVENTO_TRACE");
+    if (!path || !*path) {
+        return;
+    }
+    _path = path;
+    _enabled = true;
+    _events.reserve(4096);
+    spdlog::info("Tracing enabled, writing to {} on exit", _path.string());
+}
+
+std::int64_t Tracer::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _start).count();
+}
+
+std::uint32_t Tracer::threadId() {
+    thread_local std::uint32_t id = ++_lastThread;
+    return id;
+}
+
+void Tracer::push(Event event) {
+    std::lock_guard lock(_mutex);
+    if (_events.size() >= MAX_EVENTS) {
+        ++_dropped;
+        return;
+    }
+    _events.push_back(std::move(event));
+}
+
+void Tracer::nameThread(std::string_view name) {
+    if (!_enabled) {
+        return;
+    }
+    push({.phase = 'M',
+          .category = "__metadata",
+          .name = "thread_name",
+          .timestamp = 0,
+          .duration = 0,
+          .thread = threadId(),
+          .id = 0,
+          .detail = std::string(name)});
+}
+
+void Tracer::complete(std::string_view category,
+                      std::string_view name,
+                      Clock::time_point start,
+                      std::string_view detail) {
+    if (!_enabled) {
+        return;
+    }
+    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(start - _start);
+    push({.phase = 'X',
+          .category = std::string(category),
+          .name = std::string(name),
+          .timestamp = timestamp.count(),
+          .duration = now() - timestamp.count(),
+          .thread = threadId(),
+          .id = 0,
+          .detail = std::string(detail)});
+}
+
+void Tracer::asyncBegin(std::string_view category,
+                        std::string_view name,
+                        std::uint64_t id,
+                        std::string_view detail) {
+    if (!_enabled) {
+        return;
+    }
+    push({.phase = 'b',
+          .category = std::string(category),
+          .name = std::string(name),
+          .timestamp = now(),
+          .duration = 0,
+          .thread = threadId(),
+          .id = id,
+          .detail = std::string(detail)});
+}
+
+void Tracer::asyncEnd(std::string_view category, std::string_view name, std::uint64_t id) {
+    if (!_enabled) {
+        return;
+    }
+    push({.phase = 'e',
+          .category = std::string(category),
+          .name = std::string(name),
+          .timestamp = now(),
+          .duration = 0,
+          .thread = threadId(),
+          .id = id,
+          .detail = {}});
+}
+
+void Tracer::flow(char phase, std::string_view category, std::string_view name, std::uint64_t id) {
+    if (!_enabled || !id) {
+        return;
+    }
+    push({.phase = phase,
+          .category = std::string(category),
+          .name = std::string(name),
+          .timestamp = now(),
+          .duration = 0,
+          .thread = threadId(),
+          .id = id,
+          .detail = {}});
+}
+
+void Tracer::flush() {
+    if (!_enabled) {
+        return;
+    }
+    std::lock_guard lock(_mutex);
+    std::ofstream file(_path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open trace file: {}", _path.string());
+        return;
+    }
+
+    std::string line;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (std::size_t i = 0; i < _events.size(); ++i) {
+        auto const& event = _events[i];
+        line = "{\"ph\":\"";
+        line += event.phase;
+        line += "\",\"cat\":\"";
+        appendEscaped(line, event.category);
+        line += "\",\"name\":\"";
+        appendEscaped(line, event.name);
+        line += std::format("\",\"ts\":{},\"pid\":1,\"tid\":{}", event.timestamp, event.thread);
+        if (event.phase == 'X') {
+            line += std::format(",\"dur\":{}", event.duration);
+        }
+        if (event.id) {
+            line += std::format(",\"id\":\"0x{:x}\"", event.id);
+        }
+        if (event.phase == 'f') {
+            // bind to the enclosing slice rather than the next one
+            line += ",\"bp\":\"e\"";
+        }
+        if (event.phase == 'M') {
+            line += ",\"args\":{\"name\":\"";
+            appendEscaped(line, event.detail);
+            line += "\"}";
+        } else if (!event.detail.empty()) {
+            line += ",\"args\":{\"detail\":\"";
+            appendEscaped(line, event.detail);
+            line += "\"}";
+        }
+        line += i + 1 < _events.size() ? "},\n" : "}\n";
+        file << line;
+    }
+    file << "]}\n";
+
+    spdlog::info("Trace of {} events written to {}{}",
+                 _events.size(),
+                 _path.string(),
+                 _dropped ? std::format(", {} dropped", _dropped) : std::string());
+}
+
+Tracer* tracer() {
+    static Tracer s_instance;
+    return &s_instance;
+}
+
+} // namespace evento
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace evento {
+
+// Opt-in recorder of Chrome trace events, the output loads in https://ui.perfetto.dev.
+// Enabled by setting `EVENTO_TRACE` to the output path, the file is written by `flush()`.
+// While disabled every entry point is a single branch on `enabled()`.
+//
+// - `TraceSpan` marks synchronous work on the calling thread, e.g. a UI callback
+// - `TraceAsyncSpan` marks work that suspends, e.g. a coroutine, grouped into a track by id
+// - flow events draw arrows between spans of different threads, e.g. UI -> io -> UI
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    [[nodiscard]] bool enabled() const { return _enabled; }
+
+    // label the calling thread in the trace viewer
+    void nameThread(std::string_view name);
+    // unique id for async spans and flows, never 0
+    std::uint64_t newId() { return ++_lastId; }
+
+    void complete(std::string_view category,
+                  std::string_view name,
+                  Clock::time_point start,
+                  std::string_view detail = {});
+    void asyncBegin(std::string_view category,
+                    std::string_view name,
+                    std::uint64_t id,
+                    std::string_view detail = {});
+    void asyncEnd(std::string_view category, std::string_view name, std::uint64_t id);
+    // `phase` is 's' (start), 't' (step) or 'f' (finish),
+    // bound to the span enclosing the call on the calling thread
+    void flow(char phase, std::string_view category, std::string_view name, std::uint64_t id);
+
+    // write every event recorded so far into the output file
+    void flush();
+
+    // events beyond this are dropped, about 100MiB of memory
+    static constexpr std::size_t MAX_EVENTS = 1 << 20;
+
+private:
+    Tracer();
+
+    struct Event {
+        char phase;
+        std::string category;
+        std::string name;
+        std::int64_t timestamp; // microseconds since the tracer started
+        std::int64_t duration;  // complete events only
+        std::uint32_t thread;
+        std::uint64_t id; // async and flow events only
+        std::string detail;
+    };
+
+    std::int64_t now() const;
+    std::uint32_t threadId();
+    void push(Event event);
+
+    bool _enabled = false;
+    std::filesystem::path _path;
+    Clock::time_point _start;
+    std::atomic<std::uint64_t> _lastId = 0;
+    std::atomic<std::uint32_t> _lastThread = 0;
+    std::mutex _mutex;
+    std::vector<Event> _events;
+    std::size_t _dropped = 0;
+
+    friend Tracer* tracer();
+};
+
+Tracer* tracer();
+
+// synchronous span, recorded as a complete event when it goes out of scope
+class TraceSpan {
+public:
+    TraceSpan(std::string_view category, std::string_view name, std::string_view detail = {})
+        : _active(tracer()->enabled()) {
+        if (_active) {
+            _category = category;
+            _name = name;
+            _detail = detail;
+            _start = Tracer::Clock::now();
+        }
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    ~TraceSpan() {
+        if (_active) {
+            tracer()->complete(_category, _name, _start, _detail);
+        }
+    }
+
+private:
+    bool _active;
+    std::string _category;
+    std::string _name;
+    std::string _detail;
+    Tracer::Clock::time_point _start;
+};
+
+// span across suspension points, `id` 0 (from a disabled tracer) records nothing
+class TraceAsyncSpan {
+public:
+    TraceAsyncSpan(std::string_view category,
+                   std::string_view name,
+                   std::uint64_t id,
+                   std::string_view detail = {})
+        : _id(id) {
+        if (_id) {
+            _category = category;
+            _name = name;
+            tracer()->asyncBegin(_category, _name, _id, detail);
+        }
+    }
+    TraceAsyncSpan(const TraceAsyncSpan&) = delete;
+    TraceAsyncSpan& operator=(const TraceAsyncSpan&) = delete;
+    ~TraceAsyncSpan() { end(); }
+
+    // end before the scope does, no-op if ended already
+    void end() {
+        if (_id) {
+            tracer()->asyncEnd(_category, _name, _id);
+            _id = 0;
+        }
+    }
+
+private:
+    std::uint64_t _id;
+    std::string _category;
+    std::string _name;
+};
+
+} // namespace evento
@@ -0,0 +1,89 @@
+#include "IpcServer.h"
+#include <QApplication>
+#include <iostream>
+#include <string>
+
+using evento::tray::MessageType;
+
+IpcServer::IpcServer()
+    : server(new QLocalServer(this))
+    , socket(nullptr) {
+    QObject::connect(server, &QLocalServer::newConnection, this, &IpcServer::acceptConnection);
+    // only the user running the app may connect
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    auto name = QStringLiteral("sast-evento-tray-%1").arg(QCoreApplication::applicationPid());
+    if (!server->listen(name)) {
+        std::cerr << "Failed to listen on " << name.toStdString() << ": "
+                  << server->errorString().toStdString() << std::endl;
+    } else {
+        std::cout << server->fullServerName().toStdString() << std::endl;
+    }
+}
+
+void IpcServer::acceptConnection() {
+    socket = server->nextPendingConnection();
+    QObject::connect(socket, &QLocalSocket::readyRead, this, &IpcServer::readData);
+}
+
+void IpcServer::readData() {
+    auto data = socket->readAll();
+    reader.append(data.constData(), static_cast<std::size_t>(data.size()));
+
+    // a batch of notifications shows as one message, the tray shows one at a time anyway
+    QByteArray notifications;
+    while (auto frame = reader.next()) {
+        switch (frame->type) {
+        case MessageType::Notify:
+            if (!notifications.isEmpty()) {
+                notifications += '\n';
+            }
+            notifications += QByteArray::fromStdString(frame->payload);
+            break;
+        case MessageType::Exit:
+            emit exitAppReceived();
+            break;
+        default:
+            qWarning() << "Unknown message:" << static_cast<int>(frame->type);
+        }
+    }
+    if (!notifications.isEmpty()) {
+        emit showMessageReceived(std::move(notifications));
+    }
+    if (reader.failed()) {
+        qWarning() << "Oversized frame, disconnecting";
+        socket->abort();
+    }
+}
+
+void IpcServer::sendShowWindow() {
+    sendData(MessageType::ShowWindow);
+}
+
+void IpcServer::sendShowAboutPage() {
+    sendData(MessageType::ShowAboutPage);
+}
+
+void IpcServer::sendExitApp() {
+    sendData(MessageType::ExitApp);
+    if (socket) {
+        socket->waitForBytesWritten(1000);
+    }
+    QApplication::exit();
+}
+
+void IpcServer::sendData(MessageType type) {
+    if (!socket) {
+        return;
+    }
+    std::string frame;
+    evento::tray::appendFrame(frame, type);
+    socket->write(frame.data(), static_cast<qint64>(frame.size()));
+    socket->flush();
+}
+
+IpcServer::~IpcServer() {
+    if (socket) {
+        socket->close();
+        socket->deleteLater();
+    }
+}
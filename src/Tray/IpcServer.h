@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Infrastructure/IPC/TrayProtocol.h>
+#include <QByteArray>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+// Serves the app on a Unix domain socket, a named pipe on Windows, in frames of
+// `TrayProtocol.h`. Where it listens is printed to stdout for the app to connect to.
+class IpcServer : public QObject {
+    Q_OBJECT
+public:
+    IpcServer();
+    ~IpcServer();
+
+signals:
+    // the notifications of one batch joined by line breaks
+    void showMessageReceived(QByteArray data);
+    void exitAppReceived();
+
+public slots:
+    void sendShowWindow();
+    void sendShowAboutPage();
+    void sendExitApp();
+
+private slots:
+    void acceptConnection();
+    void readData();
+
+private:
+    void sendData(evento::tray::MessageType type);
+
+    QLocalServer* server{};
+    QLocalSocket* socket{};
+    evento::tray::FrameReader reader;
+};
@@ -1,4 +1,4 @@
-#include "TcpServer.h"
+#include "IpcServer.h"
 #include <QApplication>
 #include <QMenu>
 #include <QSystemTrayIcon>
@@ -28,18 +28,18 @@ int main(int argc, char* argv[]) {
 
     QApplication app(argc, argv);
 
-    TcpServer server;
+    IpcServer server;
 
     auto* tray = new QSystemTrayIcon(QIcon(":/img/evento.png"));
     tray->setToolTip(QStringLiteral("SAST Evento"));
     auto* menu = new QMenu();
     QAction* showAction = menu->addAction("显示");
-    QObject::connect(showAction, &QAction::triggered, &server, &TcpServer::sendShowWindow);
+    QObject::connect(showAction, &QAction::triggered, &server, &IpcServer::sendShowWindow);
     QAction* aboutAction = menu->addAction("关于");
-    QObject::connect(aboutAction, &QAction::triggered, &server, &TcpServer::sendShowAboutPage);
+    QObject::connect(aboutAction, &QAction::triggered, &server, &IpcServer::sendShowAboutPage);
     QAction* closeAction = menu->addAction("退出");
-    QObject::connect(closeAction, &QAction::triggered, &server, &TcpServer::sendExitApp);
-    QObject::connect(tray, &QSystemTrayIcon::messageClicked, &server, &TcpServer::sendShowWindow);
+    QObject::connect(closeAction, &QAction::triggered, &server, &IpcServer::sendExitApp);
+    QObject::connect(tray, &QSystemTrayIcon::messageClicked, &server, &IpcServer::sendShowWindow);
     QObject::connect(tray,
                      &QSystemTrayIcon::activated,
                      [&server](QSystemTrayIcon::ActivationReason reason) {
@@ -49,8 +49,8 @@ int main(int argc, char* argv[]) {
                      });
     tray->setContextMenu(menu);
 
-    QObject::connect(&server, &TcpServer::exitAppReceived, exitApp);
-    QObject::connect(&server, &TcpServer::showMessageReceived, [tray](QByteArray data) {
+    QObject::connect(&server, &IpcServer::exitAppReceived, exitApp);
+    QObject::connect(&server, &IpcServer::showMessageReceived, [tray](QByteArray data) {
         tray->showMessage("SAST Evento", data, QIcon(":/img/evento.png"));
     });
 
@@ -1,8 +1,13 @@
+#include <Controller/AsyncExecutor.hh>
 #include <Controller/UiBridge.h>
 #include <Infrastructure/IPC/SocketClient.h>
+#include <Infrastructure/Network/NetworkClient.h>
 #include <Infrastructure/Utils/Config.h>
 #include <Infrastructure/Utils/Logger.hh>
+#include <Infrastructure/Utils/StartupTimeline.h>
+#include <Infrastructure/Utils/Trace.h>
 #include <Version.h>
+#include <boost/asio/detached.hpp>
 #include <filesystem>
 #include <spdlog/spdlog.h>
 #ifdef PLATFORM_LINUX
@@ -11,6 +16,9 @@
 #endif
 
 int main(int argc, char** argv) {
+    auto timeline = evento::startupTimeline();
+    timeline->mark("main");
+
     Logger logger(
 #ifdef EVENTO_DEBUG
         Logger::Level::debug,
@@ -18,8 +26,18 @@ int main(int argc, char** argv) {
         Logger::Level::info,
 #endif
         (std::filesystem::temp_directory_path() / "NJUPT-SAST" / "logs" / "evento.log").string());
+    evento::tracer()->nameThread("ui");
+    timeline->mark("logger");
+
+    // resolve, connect and handshake while the config and the UI are being loaded,
+    // the UI is not up yet, so bypass `asyncExecute` and its event loop callback
+    boost::asio::co_spawn(evento::executor()->getIoContext(),
+                          evento::networkClient()->warmUpEvento(),
+                          boost::asio::detached);
+
     evento::initConfig();
     spdlog::info("SAST Evento version: v" VERSION_FULL);
+    timeline->mark("config");
 
 #ifdef PLATFORM_LINUX
     bindtextdomain("sast-evento", evento::localePath.string().c_str());
@@ -27,7 +45,12 @@ int main(int argc, char** argv) {
     spdlog::info("locale: {}", std::locale::global(std::locale("")).name());
 #endif
 
-    evento::UiBridge uiBridge(App::create());
+    timeline->mark("locale");
+
+    auto app = App::create();
+    timeline->mark("app create");
+    evento::UiBridge uiBridge(app);
+    timeline->mark("views");
 
     evento::SocketClient socketClient({
         {evento::SocketClient::MessageType::ShowWindow, [&uiBridge] { uiBridge.show(); }},
@@ -39,7 +62,7 @@ int main(int argc, char** argv) {
         {evento::SocketClient::MessageType::ExitApp, [&uiBridge] { uiBridge.exit(); }},
     });
 
-    socketClient.startTray();
+    // the tray is started once the window is drawn, and only if needed, see `SocketClient`
 
     // block until exit event loop
     uiBridge.run();
@@ -47,4 +70,5 @@ int main(int argc, char** argv) {
     socketClient.exitTray();
 
     evento::saveConfig();
+    evento::tracer()->flush();
 }
\ No newline at end of file